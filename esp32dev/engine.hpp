@@ -6,7 +6,14 @@
 
 #include "o1store.hpp"
 #include <limits>
+#include <type_traits>
 
+#ifdef USE_ASSET_PACK
+// the resources are in the asset pack mapped at 'engine_setup()' and accessed
+// through pointers with the same names and indexing as the compiled in arrays
+static const uint16_t *palette_tiles = nullptr;
+static const uint16_t *palette_sprites = nullptr;
+#else
 // palette used when rendering tiles
 // converts uint8_t to uint16_t rgb 565 (red being the highest bits)
 // note. lower and higher byte swapped
@@ -18,6 +25,7 @@ static constexpr uint16_t palette_tiles[256]{
 static constexpr uint16_t palette_sprites[256]{
 #include "game/resources/palette_sprites.hpp"
 };
+#endif
 
 // tile dimensions
 static constexpr unsigned tile_width = 16;
@@ -39,8 +47,19 @@ static constexpr unsigned tile_height_and = 15;
 
 class tile {
 public:
-  const uint8_t data[tile_width * tile_height];
-} static constexpr tiles[tile_count]{
+  // note. aligned for word-wide reads by the renderer
+  alignas(4) const uint8_t data[tile_width * tile_height];
+};
+
+#ifdef USE_ASSET_PACK
+static const tile *tiles = nullptr;
+
+class tile_map {
+public:
+  const tile_ix (*cell)[tile_map_width];
+} static tile_map{};
+#else
+static constexpr tile tiles[tile_count]{
 #include "game/resources/tile_imgs.hpp"
 };
 
@@ -50,6 +69,346 @@ public:
 } static constexpr tile_map{{
 #include "game/resources/tile_map.hpp"
 }};
+#endif
+
+// run of 'count' cells with 'tile' in a row of the compressed tile map
+class tile_map_run {
+public:
+  uint8_t count;
+  tile_ix tile;
+};
+
+#ifdef USE_ASSET_PACK
+static const tile_map_run *tile_map_runs = nullptr;
+static const uint16_t *tile_map_runs_rows = nullptr;
+#else
+// rows of 'tile_map' compressed by
+// 'utils/png-to-resources/compress-tile-map.py'
+static constexpr tile_map_run tile_map_runs[]{
+#include "game/resources/tile_map_runs.hpp"
+};
+
+// index in 'tile_map_runs' of the first run of every row of the tile map
+// note. identical rows share the same runs
+static constexpr uint16_t tile_map_runs_rows[tile_map_height]{
+#include "game/resources/tile_map_runs_rows.hpp"
+};
+#endif
+
+// ring of 'tile_map_stream_rows' rows of tiles decompressed from
+// 'tile_map_runs' around the rows on screen as the tile map scrolls
+// note. when enabled 'tile_map' is not referenced and thus not linked
+class tile_map_stream {
+public:
+  // rows of tiles on screen including partial rows at top and bottom
+  static constexpr unsigned rows_on_screen =
+      (display_height + tile_height - 1) / tile_height + 1;
+
+private:
+  static constexpr unsigned rows_count =
+      tile_map_stream_rows ? tile_map_stream_rows : 1;
+  static constexpr unsigned no_row = ~0u;
+  // rows decoded before and after the rows on screen
+  static constexpr unsigned rows_ahead =
+      rows_count > rows_on_screen ? (rows_count - rows_on_screen) / 2 : 0;
+
+  static_assert(not tile_map_stream_rows or
+                    tile_map_stream_rows >= rows_on_screen,
+                "tile_map_stream_rows must fit the rows of tiles on screen");
+
+  tile_ix rows_[rows_count][tile_map_width];
+  // row in tile map of each ring entry or 'no_row'
+  unsigned row_of_[rows_count];
+
+public:
+  tile_map_stream() {
+    for (unsigned &r : row_of_) {
+      r = no_row;
+    }
+  }
+
+  // decompresses 'row' of the tile map to 'dst'
+  static void decode(const unsigned row, tile_ix *dst) {
+    const tile_map_run *run = &tile_map_runs[tile_map_runs_rows[row]];
+    for (unsigned x = 0; x < tile_map_width; run++) {
+      for (unsigned i = 0; i < run->count; i++) {
+        dst[x++] = run->tile;
+      }
+    }
+  }
+
+  // decompresses the rows around 'tile_y' that are not in the ring
+  // called every frame by the engine while the renderer is not running
+  void update(const unsigned tile_y) {
+    const unsigned first = tile_y > rows_ahead ? tile_y - rows_ahead : 0;
+    unsigned last = tile_y + rows_on_screen + rows_ahead;
+    if (last > tile_map_height) {
+      last = tile_map_height;
+    }
+    for (unsigned row = first; row < last; row++) {
+      const unsigned ix = row % rows_count;
+      if (row_of_[ix] != row) {
+        decode(row, rows_[ix]);
+        row_of_[ix] = row;
+      }
+    }
+  }
+
+  // returns true if 'row' is in the ring
+  inline auto has_row(const unsigned row) const -> bool {
+    return row_of_[row % rows_count] == row;
+  }
+
+  // returns the tiles of 'row' which must be in the ring
+  inline auto row(const unsigned row) const -> const tile_ix * {
+    return rows_[row % rows_count];
+  }
+} static tile_map_stream{};
+
+// returns the tiles of 'row' in flash or, if 'tile_map_stream_rows', in the
+// ring of decompressed rows
+static inline auto tile_map_row(const unsigned row) -> const tile_ix * {
+  return tile_map_stream_rows ? tile_map_stream.row(row) : tile_map.cell[row];
+}
+
+// animation of a tile in the tile map cycling through tile images
+class tile_anim {
+public:
+  // tile in the map that is animated
+  tile_ix tile;
+  uint16_t frame_ms;
+  uint8_t frames_len;
+  tile_ix frames[tile_anim_frames_max];
+};
+
+static constexpr tile_anim tile_anims[tile_anims_count ? tile_anims_count : 1]{
+#include "game/resources/tile_anims.hpp"
+};
+
+// returns true if animations from index 'i' have a frame time and 1 to
+// 'tile_anim_frames_max' frames
+// note. recursive since C++11 constexpr functions are a single return
+static constexpr auto tile_anims_valid(const unsigned i) -> bool {
+  return i >= tile_anims_count or
+         (tile_anims[i].frame_ms != 0 and tile_anims[i].frames_len != 0 and
+          tile_anims[i].frames_len <= tile_anim_frames_max and
+          tile_anims_valid(i + 1));
+}
+
+static_assert(tile_anims_valid(0), "every entry in 'tile_anims' must have "
+                                   "'frame_ms' not 0 and 'frames_len' 1 to "
+                                   "'tile_anim_frames_max'");
+
+// indirection from tile in map to tile image updated every frame by the tile
+// animations
+// note. the renderer looks up the table only if 'tile_anims_count'
+class tile_remap {
+  tile_ix remap_[tile_count];
+  // true if image of tile changed at last 'update()'
+  bool changed_[tile_count]{};
+  bool any_changed_ = false;
+
+public:
+  tile_remap() {
+    for (unsigned i = 0; i < tile_count; i++) {
+      remap_[i] = tile_ix(i);
+    }
+  }
+
+  // returns the tile image of tile in map
+  inline auto tile_of(const tile_ix ix) const -> tile_ix {
+    return tile_anims_count ? remap_[ix] : ix;
+  }
+
+  // sets the frames of the animations at time 'ms'
+  // called every frame by the engine while the renderer is not running
+  void update(const unsigned long ms) {
+    any_changed_ = false;
+    for (unsigned i = 0; i < tile_anims_count; i++) {
+      const tile_anim &anim = tile_anims[i];
+      const tile_ix frame = anim.frames[ms / anim.frame_ms % anim.frames_len];
+      changed_[anim.tile] = remap_[anim.tile] != frame;
+      if (changed_[anim.tile]) {
+        remap_[anim.tile] = frame;
+        any_changed_ = true;
+      }
+    }
+  }
+
+  // returns true if any of the 'n' tiles in map 'row' changed image at last
+  // 'update()'
+  // note. used by renderer when 'render_dirty_rows'
+  auto row_changed(const tile_ix *row, const unsigned n) const -> bool {
+    if (not any_changed_) {
+      return false;
+    }
+    for (unsigned i = 0; i < n; i++) {
+      if (changed_[row[i]]) {
+        return true;
+      }
+    }
+    return false;
+  }
+} static tile_remap{};
+
+// modifiable tile map where a row of tiles stays in flash until first written,
+// then it is copied to a pool of 'tile_map_ram_rows' rows in ram
+// note. the renderer resolves the row of tiles once for every band
+class tile_map_overlay {
+  static constexpr uint8_t in_flash = 0xff;
+  static constexpr unsigned bitset_words = (tile_map_height + 31) / 32;
+
+  static_assert(tile_map_ram_rows < in_flash,
+                "tile_map_ram_rows must be less than 255");
+
+  // index in 'pool_' of the row or 'in_flash'
+  uint8_t slot_[tile_map_ram_rows ? tile_map_height : 1];
+  tile_ix pool_[tile_map_ram_rows ? tile_map_ram_rows : 1][tile_map_width];
+  unsigned pool_len_ = 0;
+  // rows written since last 'on_render()'
+  uint32_t written_[bitset_words]{};
+  // rows written before the frame being rendered
+  uint32_t dirty_[bitset_words]{};
+
+public:
+  tile_map_overlay() {
+    for (uint8_t &s : slot_) {
+      s = in_flash;
+    }
+  }
+
+  // returns the tiles of 'row'
+  inline auto row(const unsigned row) const -> const tile_ix * {
+    if (not tile_map_ram_rows or slot_[row] == in_flash) {
+      return tile_map_row(row);
+    }
+    return pool_[slot_[row]];
+  }
+
+  // returns the tile at 'x', 'y' in tile map coordinates
+  // note. when 'tile_map_stream_rows' the row must be in ram or in the ring
+  inline auto get(const unsigned x, const unsigned y) const -> tile_ix {
+    return row(y)[x];
+  }
+
+  // sets the tile at 'x', 'y' in tile map coordinates
+  // returns false if the row is in flash and there are no free rows in ram or,
+  // when 'tile_map_stream_rows', the row is not in the ring
+  auto set(const unsigned x, const unsigned y, const tile_ix tile) -> bool {
+    if (not tile_map_ram_rows) {
+      return false;
+    }
+    if (slot_[y] == in_flash) {
+      if (pool_len_ == tile_map_ram_rows or
+          (tile_map_stream_rows and not tile_map_stream.has_row(y))) {
+        return false;
+      }
+      memcpy(pool_[pool_len_], tile_map_row(y), sizeof(pool_[0]));
+      slot_[y] = uint8_t(pool_len_);
+      pool_len_++;
+    }
+    pool_[slot_[y]][x] = tile;
+    written_[y >> 5] |= 1u << (y & 31);
+    return true;
+  }
+
+  // number of rows copied to ram
+  inline auto ram_rows_len() const -> unsigned { return pool_len_; }
+
+  // called every frame by the engine before render, the rows written since
+  // previous call become dirty for the frame
+  void on_render() {
+    memcpy(dirty_, written_, sizeof(dirty_));
+    memset(written_, 0, sizeof(written_));
+  }
+
+  // returns true if 'row' was written before the frame being rendered
+  // note. used by renderer when 'render_dirty_rows'
+  inline auto is_dirty(const unsigned row) const -> bool {
+    return tile_map_ram_rows and (dirty_[row >> 5] & (1u << (row & 31)));
+  }
+} static tile_map_overlay{};
+
+// the 'tile_cache_size' most used tiles in 'tile_map' expanded to rgb 565
+// pixels so that the renderer copies rows instead of looking up the palette
+class tile_cache {
+  // pixels of cached tiles, allocated at 'init()'
+  uint16_t *pixels_ = nullptr;
+  // number of cached tiles
+  unsigned count_ = 0;
+  // pointer to pixels of tile or nullptr if tile is not cached
+  const uint16_t *tile_pixels_[tile_count]{};
+
+public:
+  // selects the most used tiles in 'tile_map' and expands them
+  // called at 'engine_setup()'
+  void init() {
+    if (not tile_cache_size) {
+      return;
+    }
+    // histogram of tiles in tile map
+    unsigned counts[tile_count]{};
+    unsigned used = 0;
+    tile_ix row_buf[tile_map_width];
+    for (unsigned y = 0; y < tile_map_height; y++) {
+      const tile_ix *row = tile_map.cell[y];
+      if (tile_map_stream_rows) {
+        tile_map_stream::decode(y, row_buf);
+        row = row_buf;
+      }
+      for (unsigned x = 0; x < tile_map_width; x++) {
+        if (counts[row[x]]++ == 0) {
+          used++;
+        }
+      }
+    }
+    // frames of animated tiles are used as often as the tile
+    for (unsigned i = 0; i < tile_anims_count; i++) {
+      const tile_anim &anim = tile_anims[i];
+      for (unsigned f = 0; f < anim.frames_len; f++) {
+        if (anim.frames[f] != anim.tile and counts[anim.frames[f]] == 0) {
+          counts[anim.frames[f]] = counts[anim.tile];
+          used++;
+        }
+      }
+    }
+    count_ = used < tile_cache_size ? used : tile_cache_size;
+    pixels_ = (uint16_t *)malloc(allocated_data_size_B());
+    if (!pixels_) {
+      Serial.printf("!!! could not allocate tile cache");
+      while (true)
+        ;
+    }
+    // expand the most used tiles
+    uint16_t *dst = pixels_;
+    for (unsigned i = 0; i < count_; i++) {
+      unsigned max_ix = 0;
+      for (unsigned t = 1; t < tile_count; t++) {
+        if (counts[t] > counts[max_ix]) {
+          max_ix = t;
+        }
+      }
+      counts[max_ix] = 0;
+      tile_pixels_[max_ix] = dst;
+      for (const uint8_t px : tiles[max_ix].data) {
+        *dst++ = palette_tiles[px];
+      }
+    }
+  }
+
+  // returns pointer to the expanded pixels of tile or nullptr if not cached
+  inline auto pixels(const tile_ix ix) const -> const uint16_t * {
+    return tile_cache_size ? tile_pixels_[ix] : nullptr;
+  }
+
+  // returns number of cached tiles
+  inline auto count() const -> unsigned { return count_; }
+
+  // returns the size in bytes of allocated heap memory
+  inline auto allocated_data_size_B() const -> size_t {
+    return count_ * tile_width * tile_height * sizeof(uint16_t);
+  }
+} static tile_cache{};
 
 // tile map controls
 static float tile_map_x = 0;
@@ -57,6 +416,11 @@ static float tile_map_dx = 0;
 static float tile_map_y = 0;
 static float tile_map_dy = 0;
 
+// tile map position at previous simulation step used to interpolate the
+// rendered position when 'engine_fixed_dt_ms'
+static float tile_map_prv_x = 0;
+static float tile_map_prv_y = 0;
+
 // sprite dimensions
 static constexpr unsigned sprite_width = 16;
 static constexpr unsigned sprite_height = 16;
@@ -64,93 +428,420 @@ static constexpr unsigned sprite_height = 16;
 static constexpr int16_t sprite_width_neg = -int16_t(sprite_width);
 // used when rendering
 
+// span of opaque pixels in a row of a sprite image
+class sprite_img_span {
+public:
+  uint8_t x;
+  uint8_t len;
+};
+
+#ifdef USE_ASSET_PACK
+static const uint8_t (*sprite_imgs)[sprite_width * sprite_height] = nullptr;
+static const sprite_img_span *sprite_img_spans = nullptr;
+static const uint16_t *sprite_img_spans_rows = nullptr;
+#else
 // images used by sprites
 static constexpr uint8_t sprite_imgs[sprite_imgs_count]
                                     [sprite_width * sprite_height]{
 #include "game/resources/sprite_imgs.hpp"
                                     };
 
-using sprite_ix = uint8_t;
-// data type used to index a sprite
-// note. for 'collision_map' to fit in a contiguous block of heap it must be
-// 8-bit
+// opaque spans of the rows of the sprite images
+static constexpr sprite_img_span sprite_img_spans[]{
+#include "game/resources/sprite_imgs_spans.hpp"
+};
+
+// index in 'sprite_img_spans' of the first span of every row of the sprite
+// images where the spans of a row end at the first span of the next row
+static constexpr uint16_t
+    sprite_img_spans_rows[sprite_imgs_count * sprite_height + 1]{
+#include "game/resources/sprite_imgs_spans_rows.hpp"
+};
+#endif
+
+#ifdef USE_ASSET_PACK
+// returns the asset pack mapped in memory and the mapped size in 'size' or
+// nullptr if not found
+// note. implemented by the platform
+static auto asset_pack_map(uint32_t &size) -> const uint8_t *;
+
+// resources in the binary asset pack generated by
+// 'utils/png-to-resources/make-asset-pack.py'
+// format, little endian, blocks aligned to 4 B:
+//   "APAK", u16 version, u16 blocks count, u32 size of pack, u32 fnv-1a hash
+//   of the bytes after the header, for every block: 4 characters id, u32 offset
+//   from start of pack, u32 size, then the blocks
+// note. content is checked by 'utils/png-to-resources/validate-asset-pack.py'
+//       and at 'init()' the hash, the block sizes and the row indexes of the
+//       spans and tile map runs are verified
+class asset_pack {
+public:
+  static constexpr uint16_t version = 1;
+
+private:
+  static constexpr unsigned header_size = 16;
+  static constexpr unsigned entry_size = 12;
+
+  const uint8_t *pack_ = nullptr;
+  uint32_t size_ = 0;
+
+  static inline auto read_u16(const uint8_t *p) -> uint16_t {
+    return uint16_t(p[0] | p[1] << 8);
+  }
+
+  static inline auto read_u32(const uint8_t *p) -> uint32_t {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 |
+           uint32_t(p[3]) << 24;
+  }
+
+  static void fail(const char *msg, const char *id) {
+    Serial.printf("!!! asset pack: %s %s\n", msg, id);
+    while (true)
+      ;
+  }
+
+  // returns fnv-1a hash of 'n' bytes at 'p'
+  static auto fnv1a(const uint8_t *p, const uint32_t n) -> uint32_t {
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < n; i++) {
+      h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+  }
+
+  // checks that the spans of every sprite image row are in 'spans_len' spans
+  // and within the width of the sprite
+  static void verify_spans(const uint32_t spans_len) {
+    constexpr unsigned rows = sprite_imgs_count * sprite_height;
+    for (unsigned i = 0; i < rows; i++) {
+      if (sprite_img_spans_rows[i] > sprite_img_spans_rows[i + 1]) {
+        fail("row index of spans decreasing", "SPRW");
+      }
+    }
+    if (sprite_img_spans_rows[rows] > spans_len) {
+      fail("row index of spans beyond spans", "SPRW");
+    }
+    for (unsigned i = 0; i < sprite_img_spans_rows[rows]; i++) {
+      const sprite_img_span &span = sprite_img_spans[i];
+      if (span.x + span.len > sprite_width) {
+        fail("span beyond sprite width", "SPAN");
+      }
+    }
+  }
+
+  // checks that the runs of every tile map row are in 'runs_len' runs and
+  // expand to exactly 'tile_map_width' tiles
+  static void verify_runs(const uint32_t runs_len) {
+    for (unsigned row = 0; row < tile_map_height; row++) {
+      unsigned ix = tile_map_runs_rows[row];
+      unsigned x = 0;
+      while (x < tile_map_width) {
+        if (ix >= runs_len) {
+          fail("row index of runs beyond runs", "TRRW");
+        }
+        if (tile_map_runs[ix].count == 0) {
+          fail("run with no tiles", "TRUN");
+        }
+        x += tile_map_runs[ix].count;
+        ix++;
+      }
+      if (x != tile_map_width) {
+        fail("runs of row do not match map width", "TRUN");
+      }
+    }
+  }
+
+  // returns block 'id' which must be 'size' B or, if 'len' is not nullptr,
+  // any size returned in 'len'
+  auto block(const char *id, const uint32_t size,
+             uint32_t *len = nullptr) const -> const void * {
+    const unsigned n = read_u16(pack_ + 6);
+    for (unsigned i = 0; i < n; i++) {
+      const uint8_t *entry = pack_ + header_size + i * entry_size;
+      if (memcmp(entry, id, 4)) {
+        continue;
+      }
+      const uint32_t offset = read_u32(entry + 4);
+      const uint32_t block_size = read_u32(entry + 8);
+      if (offset % 4 or offset > size_ or block_size > size_ - offset) {
+        fail("block out of bounds or not aligned", id);
+      }
+      if (len) {
+        *len = block_size;
+      } else if (block_size != size) {
+        fail("block size does not match 'defs.hpp'", id);
+      }
+      return pack_ + offset;
+    }
+    fail("missing block", id);
+    return nullptr;
+  }
+
+public:
+  // maps the asset pack and points the resources to its blocks
+  // called at 'engine_setup()'
+  void init() {
+    uint32_t mapped_size = 0;
+    pack_ = asset_pack_map(mapped_size);
+    if (!pack_) {
+      fail("not found", "");
+    }
+    if (mapped_size < header_size or memcmp(pack_, "APAK", 4) or
+        read_u16(pack_ + 4) != version) {
+      fail("unknown format or version", "");
+    }
+    size_ = read_u32(pack_ + 8);
+    if (size_ > mapped_size or
+        header_size + read_u16(pack_ + 6) * entry_size > size_) {
+      fail("truncated", "");
+    }
+    if (fnv1a(pack_ + header_size, size_ - header_size) !=
+        read_u32(pack_ + 12)) {
+      fail("hash does not match", "");
+    }
+    palette_tiles = (const uint16_t *)block("PALT", 256 * sizeof(uint16_t));
+    palette_sprites = (const uint16_t *)block("PALS", 256 * sizeof(uint16_t));
+    tiles = (const tile *)block("TILE", tile_count * sizeof(tile));
+    sprite_imgs = (const uint8_t(*)[sprite_width * sprite_height])block(
+        "SPRT", sprite_imgs_count * sprite_width * sprite_height);
+    uint32_t len = 0;
+    sprite_img_spans = (const sprite_img_span *)block("SPAN", 0, &len);
+    if (len % sizeof(sprite_img_span)) {
+      fail("block size not a multiple of entry size", "SPAN");
+    }
+    const uint32_t spans_len = len / sizeof(sprite_img_span);
+    sprite_img_spans_rows = (const uint16_t *)block(
+        "SPRW", (sprite_imgs_count * sprite_height + 1) * sizeof(uint16_t));
+    tile_map.cell = (const tile_ix(*)[tile_map_width])block(
+        "TMAP", tile_map_height * tile_map_width * sizeof(tile_ix));
+    tile_map_runs = (const tile_map_run *)block("TRUN", 0, &len);
+    if (len % sizeof(tile_map_run)) {
+      fail("block size not a multiple of entry size", "TRUN");
+    }
+    const uint32_t runs_len = len / sizeof(tile_map_run);
+    tile_map_runs_rows = (const uint16_t *)block(
+        "TRRW", tile_map_height * sizeof(uint16_t));
+    verify_spans(spans_len);
+    verify_runs(runs_len);
+  }
+
+  // size of the mapped asset pack
+  inline auto size_B() const -> uint32_t { return size_; }
+} static asset_pack{};
+#endif
 
 // the reserved 'sprite_ix' in 'collision_map' representing 'no sprite pixel'
+// note. all bits set thus 'memset' with it sets elements of any width
 static constexpr sprite_ix sprite_ix_reserved =
     std::numeric_limits<sprite_ix>::max();
 
+static_assert(sprites_count <= sprite_ix_reserved,
+              "'sprites_count' must fit in 'sprite_ix' excluding reserved");
+
 // forward declaration of type
 class object;
 
+// bits of 'sprite::flip' mirroring the image when rendered
+enum sprite_flip : uint8_t {
+  sprite_flip_none = 0,
+  sprite_flip_h = 1, // mirrored horizontally
+  sprite_flip_v = 2  // mirrored vertically
+};
+
 class sprite {
 public:
   object *obj = nullptr;
   uint8_t const *img = nullptr;
+  // palette used instead of 'palette_sprites' if not nullptr
+  const uint16_t *palette = nullptr;
   int16_t scr_x = 0;
   int16_t scr_y = 0;
+  // bits of 'enum sprite_flip'
+  uint8_t flip = sprite_flip_none;
   sprite **alloc_ptr = nullptr;
+
+  // returns true if sprite has an image and is at least partially on screen
+  inline auto is_on_screen() const -> bool {
+    return img and scr_y > -int16_t(sprite_height) and
+           scr_y < int16_t(display_height) and scr_x > sprite_width_neg and
+           scr_x < int16_t(display_width);
+  }
 };
 
-using sprites_store = o1store<sprite, 255, 1>;
-// note. 255 because sprite_ix a.k.a. uint8_t max size is 255
-// note. sprite 255 is reserved which gives 255 [0:254] usable sprites
+using sprites_store = o1store<sprite, sprites_count, 1>;
 
 static sprites_store sprites{};
 
+// number of tasks rasterizing bands of the screen concurrently
+static constexpr unsigned render_workers = render_parallel_bands ? 2 : 1;
+
+static_assert(not render_parallel_bands or
+                  (collision_map_band and not engine_pipelined),
+              "'render_parallel_bands' requires 'collision_map_band' and not "
+              "'engine_pipelined'");
+
+// note. a full screen 16-bit collision map does not fit in a contiguous block of
+//       heap on the device
+static_assert(sizeof(sprite_ix) == 1 or collision_map_band,
+              "'sprite_ix' wider than 8 bits requires 'collision_map_band'");
+
 // pixel precision collision detection between on screen sprites
 // allocated at 'engine_setup()'
+// note. if 'collision_map_band' the map is one tile height of scanlines
+//       re-used by the renderer for every row of tiles, one map per render
+//       worker
 static sprite_ix *collision_map;
+static constexpr unsigned collision_map_len =
+    display_width * (collision_map_band ? tile_height : display_height);
 static constexpr unsigned collision_map_size =
-    sizeof(sprite_ix) * display_width * display_height;
+    sizeof(sprite_ix) * collision_map_len * render_workers;
+
+// true if the collision map of render worker has been written since it was
+// cleared
+// note. set by the renderer when rendering a sprite that might collide
+static bool collision_map_dirty[render_workers]{};
+
+// returns the collision map of render worker
+static inline auto collision_map_of(const unsigned worker) -> sprite_ix * {
+  return collision_map + worker * collision_map_len;
+}
+
+// clears the collision map of render worker if it has been written
+static inline void collision_map_clear(const unsigned worker = 0) {
+  if (collision_map_dirty[worker]) {
+    memset(collision_map_of(worker), sprite_ix_reserved,
+           sizeof(sprite_ix) * collision_map_len);
+    collision_map_dirty[worker] = false;
+  }
+}
 
 // helper class managing current frame time, dt, frames per second calculation
+// note. when 'engine_fixed_dt_ms' the time is advanced by fixed simulation
+//       steps, 0 or more per frame
 class clk {
 public:
   using time = unsigned long;
 
+  // maximum simulation steps per frame when 'engine_fixed_dt_ms'
+  // note. time that cannot be simulated is dropped thus the game slows down
+  //       instead of spending more time simulating every frame
+  static constexpr unsigned steps_max = 4;
+
 private:
+  // simulation step in milliseconds
+  // note. 1 when not 'engine_fixed_dt_ms' to not divide by 0
+  static constexpr unsigned step_ms =
+      engine_fixed_dt_ms ? engine_fixed_dt_ms : 1;
+
   unsigned interval_ms_ = 5000;
   unsigned frames_rendered_since_last_update_ = 0;
   time last_fps_update_ms_ = 0;
   time prv_ms_ = 0;
+  // time not yet simulated when 'engine_fixed_dt_ms'
+  time acc_ms_ = 0;
 
 public:
   // current time since boot in milliseconds
+  // note. when 'engine_fixed_dt_ms' time of the simulation step
   time ms = 0;
 
   // frame delta time in seconds
-  float dt = 0;
+  // note. when 'engine_fixed_dt_ms' simulation step in seconds
+  float dt = engine_fixed_dt_ms ? 0.001f * engine_fixed_dt_ms : 0;
 
   // current frames per second calculated at interval specified at 'init'
   unsigned fps = 0;
 
+  // number of simulation steps in current frame
+  // note. always 1 unless 'engine_fixed_dt_ms'
+  unsigned steps = 1;
+
+  // fraction of a simulation step that the frame time is past the last step
+  // used to interpolate between the states of the two last steps
+  // note. always 0 unless 'engine_fixed_dt_ms'
+  float alpha = 0;
+
   // called at setup with current time and frames per seconds calculation
   // interval
   void init(const unsigned long time_ms,
             const unsigned interval_of_fps_calculation_ms) {
+    ms = time_ms;
     last_fps_update_ms_ = prv_ms_ = ms;
     interval_ms_ = interval_of_fps_calculation_ms;
-    ms = time_ms;
   }
 
   // called before every frame to update state
   // returns true if new frames per second calculation was done
   auto on_frame(const unsigned long time_ms) -> bool {
-    ms = time_ms;
-    dt = 0.001f * (ms - prv_ms_);
-    prv_ms_ = ms;
+    if (engine_fixed_dt_ms) {
+      acc_ms_ += time_ms - prv_ms_;
+      steps = unsigned(acc_ms_ / step_ms);
+      if (steps > steps_max) {
+        steps = steps_max;
+        acc_ms_ = steps_max * step_ms;
+      }
+      acc_ms_ -= steps * step_ms;
+      alpha = float(acc_ms_) / step_ms;
+    } else {
+      ms = time_ms;
+      dt = 0.001f * (ms - prv_ms_);
+    }
+    prv_ms_ = time_ms;
     frames_rendered_since_last_update_++;
-    const unsigned long dt_ms = ms - last_fps_update_ms_;
+    const unsigned long dt_ms = time_ms - last_fps_update_ms_;
     if (dt_ms >= interval_ms_) {
       fps = frames_rendered_since_last_update_ * 1000 / dt_ms;
       frames_rendered_since_last_update_ = 0;
-      last_fps_update_ms_ = ms;
+      last_fps_update_ms_ = time_ms;
       return true;
     }
     return false;
   }
+
+  // called before every simulation step when 'engine_fixed_dt_ms'
+  void on_step() { ms += engine_fixed_dt_ms; }
 } static clk{};
 
+// forward declaration of platform specific function
+// returns time stamp in ticks of the platform e.g. cpu cycles
+static auto engine_ticks() -> uint32_t;
+
+// called at 'engine_setup()' when the resources are available
+// note. implemented in 'renderer.hpp'
+static void render_init();
+
+// calls, time spent in 'update()', allocations and frees of objects by class
+// accumulated since last 'clear()' when 'engine_class_stats'
+class object_class_stats {
+public:
+  class entry {
+  public:
+    uint32_t updates;
+    uint32_t update_ticks;
+    uint32_t allocs;
+    uint32_t frees;
+  };
+
+  entry of_class[object_class_count]{};
+
+  // number of 'objects.update()' calls
+  unsigned frames = 0;
+
+  inline void on_alloc(const object_class cls) { of_class[cls].allocs++; }
+
+  inline void on_free(const object_class cls) { of_class[cls].frees++; }
+
+  inline void on_update(const object_class cls, const uint32_t ticks) {
+    of_class[cls].updates++;
+    of_class[cls].update_ticks += ticks;
+  }
+
+  void clear() {
+    memset(of_class, 0, sizeof(of_class));
+    frames = 0;
+  }
+} static object_class_stats{};
+
 class object {
 public:
   object **alloc_ptr;
@@ -163,7 +854,14 @@ public:
   // note: used to declare interest in collisions with objects whose
   // 'col_bits' bitwise AND with this 'col_mask' is not 0
 
-  object() {}
+  // run time information about the class of this object
+  const object_class cls;
+
+  object(const object_class c) : cls{c} {
+    if (engine_class_stats) {
+      object_class_stats.on_alloc(cls);
+    }
+  }
   // note. constructor must be defined because the default constructor
   // overwrites the 'o1store' assigned 'alloc_ptr' at the 'new in place'
 
@@ -178,22 +876,263 @@ public:
   virtual void pre_render() {}
 };
 
-using object_store = o1store<object, 255, 2, object_instance_max_size_B>;
+// returns the sum of 'object_class_capacity' from class 'cls'
+static constexpr auto object_class_capacity_sum(const unsigned cls = 0)
+    -> unsigned {
+  return cls < object_class_count
+             ? object_class_capacity[cls] + object_class_capacity_sum(cls + 1)
+             : 0;
+}
+
+// returns the largest entry in 'object_class_capacity' from class 'cls'
+static constexpr auto object_class_capacity_max(const unsigned cls = 0)
+    -> unsigned {
+  return cls < object_class_count
+             ? (object_class_capacity[cls] > object_class_capacity_max(cls + 1)
+                    ? object_class_capacity[cls]
+                    : object_class_capacity_max(cls + 1))
+             : 0;
+}
+
+// returns the sprites allocated in addition to one per object by the classes
+// from 'cls' at capacity
+static constexpr auto object_class_sprites_extra(const unsigned cls = 0)
+    -> unsigned {
+  return cls < object_class_count
+             ? (object_class_sprites[cls] > 1
+                    ? (object_class_sprites[cls] - 1) *
+                          object_class_capacity[cls]
+                    : 0) +
+                   object_class_sprites_extra(cls + 1)
+             : 0;
+}
+
+// note. game objects allocate their sprites in the constructor without a
+//       check thus the sprites of any 'objects_count' objects must fit
+static_assert(objects_count + object_class_sprites_extra() <= sprites_count,
+              "sprites of 'objects_count' objects must fit 'sprites_count'");
+
+// type used to index objects, e.g. lanes in 'kinematics' and instances in the
+// class pools of 'objects', sized to fit 'objects_count' and the sum of the
+// class capacities
+using object_ix =
+    std::conditional<objects_count <= 256 and
+                         object_class_capacity_sum() <= 256,
+                     uint8_t, uint16_t>::type;
+
+// list of the types of object classes, in the order of 'enum object_class',
+// given to 'objects.init(...)' and 'objects.update_batched(...)'
+template <typename... Classes> class object_classes {};
+
+// objects allocated from a pool for each class where the instance size is the
+// size of the type of the class and capacity is 'object_class_capacity[cls]'
+// note. allocation and deferred free as in 'o1store' with one list of
+//       allocated objects of all classes
+// note. every pool also keeps a list of its allocated instances used by
+//       'update_batched()'
+class objects {
+  // pre-allocated instances of a class
+  class pool {
+  public:
+    char *data;
+    size_t instance_size_B;
+    // instances where the first 'len' are allocated and the rest free
+    object **list;
+    unsigned len;
+    unsigned capacity;
+    // index in 'list' of every instance in 'data'
+    object_ix *list_ix;
+  };
+
+  pool pools_[object_class_count]{};
+
+  static_assert(objects_count - 1 <= object_ix(~0u),
+                "'objects_count' must fit 'object_ix'");
+  static_assert(object_class_capacity_max() - 1 <= object_ix(~0u),
+                "every 'object_class_capacity' must fit 'object_ix'");
+  static_assert(object_class_capacity_sum() - 1 <= object_ix(~0u),
+                "sum of 'object_class_capacity' must fit 'object_ix'");
+
+  object *alloc_[objects_count];
+  object **alloc_ptr_ = alloc_;
+  object *del_[objects_count];
+  object **del_ptr_ = del_;
+  // size of pools and their lists
+  size_t pools_size_B_ = 0;
 
-class objects : public object_store {
 public:
+  // allocates the pools of the object classes
+  // note. called by user code at 'main_init_objects()'
+  template <typename... Classes> void init(object_classes<Classes...>) {
+    static_assert(sizeof...(Classes) == object_class_count,
+                  "one type for each entry in 'enum object_class'");
+    unsigned cls = 0;
+    const int expand[]{0, (init_pool(cls++, sizeof(Classes)), 0)...};
+    (void)expand;
+  }
+
+  // returns true if an instance of class 'cls' can be allocated
+  inline auto can_allocate(const object_class cls) -> bool {
+    const pool &p = pools_[cls];
+    return alloc_ptr_ < alloc_ + objects_count and p.len < p.capacity;
+  }
+
+  // allocates an instance of class 'cls'
+  // returns nullptr if pool of class is exhausted
+  auto allocate_instance(const object_class cls) -> object * {
+    if (not can_allocate(cls)) {
+      return nullptr;
+    }
+    pool &p = pools_[cls];
+    object *inst = p.list[p.len];
+    p.list_ix[instance_ix(p, inst)] = object_ix(p.len);
+    p.len++;
+    *alloc_ptr_ = inst;
+    inst->alloc_ptr = alloc_ptr_;
+    alloc_ptr_++;
+    return inst;
+  }
+
+  // adds instance to a list that is applied with 'apply_free()'
+  void free_instance(object *inst) {
+    if (del_ptr_ >= del_ + objects_count) {
+      Serial.printf("!!! objects: free overrun\n");
+      while (true)
+        ;
+    }
+    *del_ptr_ = inst;
+    del_ptr_++;
+  }
+
+  // de-allocates the instances that have been freed
+  void apply_free() {
+    for (object **it = del_; it < del_ptr_; it++) {
+      object *inst_deleted = *it;
+      alloc_ptr_--;
+      object *inst_to_move = *alloc_ptr_;
+      inst_to_move->alloc_ptr = inst_deleted->alloc_ptr;
+      *(inst_deleted->alloc_ptr) = inst_to_move;
+      // move last allocated instance of the pool to the place of the deleted
+      pool &p = pools_[inst_deleted->cls];
+      p.len--;
+      const unsigned ix = p.list_ix[instance_ix(p, inst_deleted)];
+      object *inst_last = p.list[p.len];
+      p.list[ix] = inst_last;
+      p.list_ix[instance_ix(p, inst_last)] = object_ix(ix);
+      p.list[p.len] = inst_deleted;
+    }
+    del_ptr_ = del_;
+  }
+
+  // returns pointer to list of allocated instances
+  inline auto allocated_list() -> object ** { return alloc_; }
+
+  // returns size of list of allocated instances
+  inline auto allocated_list_len() -> unsigned {
+    return unsigned(alloc_ptr_ - alloc_);
+  }
+
+  // returns the size in bytes of allocated heap memory
+  inline auto allocated_data_size_B() -> size_t { return pools_size_B_; }
+
   void update() {
     object **it = allocated_list();
     const unsigned len = allocated_list_len();
     for (unsigned i = 0; i < len; i++, it++) {
       object *obj = *it;
-      if (obj->update()) {
-        obj->~object();
-        free_instance(obj);
+      const uint32_t t0 = engine_class_stats ? engine_ticks() : 0;
+      on_updated(obj, obj->update(), t0);
+    }
+    if (engine_class_stats) {
+      object_class_stats.frames++;
+    }
+  }
+
+  // same as 'update()' but objects are updated by class from the allocated
+  // list of the pool calling 'update()' of the type in 'Classes' without
+  // virtual dispatch
+  // note. 'Classes' are in the order of 'enum object_class' where an object
+  //       with class 'cls' has the type at index 'cls' in 'Classes'
+  // note. objects allocated during the update are not updated, same as in
+  //       'update()'
+  template <typename... Classes>
+  void update_batched(object_classes<Classes...>) {
+    static_assert(sizeof...(Classes) == object_class_count,
+                  "one type for each entry in 'enum object_class'");
+
+    // number of allocated objects of each class before the update
+    unsigned lens[object_class_count];
+    for (unsigned c = 0; c < object_class_count; c++) {
+      lens[c] = pools_[c].len;
+    }
+
+    // update the classes in the order of 'Classes'
+    unsigned cls = 0;
+    const int expand[]{0, (update_class<Classes>(cls++, lens), 0)...};
+    (void)expand;
+
+    if (engine_class_stats) {
+      object_class_stats.frames++;
+    }
+  }
+
+private:
+  void init_pool(const unsigned cls, const size_t instance_size_B) {
+    const unsigned n = object_class_capacity[cls];
+    pool &p = pools_[cls];
+    p.data = (char *)calloc(n, instance_size_B);
+    p.list = (object **)calloc(n, sizeof(object *));
+    p.list_ix = (object_ix *)calloc(n, sizeof(object_ix));
+    if (n and (!p.data or !p.list or !p.list_ix)) {
+      Serial.printf("!!! objects: could not allocate pool of class %u\n", cls);
+      while (true)
+        ;
+    }
+    p.instance_size_B = instance_size_B;
+    p.len = 0;
+    p.capacity = n;
+    // all instances are free
+    for (unsigned i = 0; i < n; i++) {
+      p.list[i] = (object *)(p.data + i * instance_size_B);
+    }
+    pools_size_B_ +=
+        n * (instance_size_B + sizeof(object *) + sizeof(object_ix));
+  }
+
+  // returns index of 'inst' in 'data' of pool 'p'
+  static inline auto instance_ix(const pool &p, const object *inst)
+      -> unsigned {
+    return unsigned(((const char *)inst - p.data) / p.instance_size_B);
+  }
+
+  // updates the first 'lens[cls]' allocated objects of class 'cls'
+  // note. objects are freed after the update thus the list only grows
+  template <typename Cls>
+  void update_class(const unsigned cls, const unsigned *lens) {
+    const unsigned len = lens[cls];
+    object **list = pools_[cls].list;
+    for (unsigned i = 0; i < len; i++) {
+      Cls *obj = static_cast<Cls *>(list[i]);
+      const uint32_t t0 = engine_class_stats ? engine_ticks() : 0;
+      on_updated(obj, obj->Cls::update(), t0);
+    }
+  }
+
+  // accounts 'update()' of 'obj' started at 't0' and frees 'obj' if it 'died'
+  inline void on_updated(object *obj, const bool died, const uint32_t t0) {
+    if (engine_class_stats) {
+      object_class_stats.on_update(obj->cls, engine_ticks() - t0);
+    }
+    if (died) {
+      if (engine_class_stats) {
+        object_class_stats.on_free(obj->cls);
       }
+      obj->~object();
+      free_instance(obj);
     }
   }
 
+public:
   void pre_render() {
     object **it = allocated_list();
     const unsigned len = allocated_list_len();
@@ -204,7 +1143,713 @@ public:
   }
 } static objects{};
 
+// position, velocity and acceleration of objects in a structure of arrays
+// integrated in one pass when 'engine_kinematics_soa'
+// note. object allocates a lane at construction and frees it at destruction
+// note. allocated lanes are kept compact, a freed lane is replaced by the last
+//       lane and the index held by the owner of the moved lane is updated
+class kinematics {
+public:
+  // number of lanes, 1 when not used
+  static constexpr unsigned lanes_count =
+      engine_kinematics_soa ? objects_count : 1;
+
+  float ddx[lanes_count]{};
+  float dx[lanes_count]{};
+  float x[lanes_count]{};
+  float ddy[lanes_count]{};
+  float dy[lanes_count]{};
+  float y[lanes_count]{};
+  // position at previous 'update()'
+  float prv_x[lanes_count]{};
+  float prv_y[lanes_count]{};
+
+private:
+  // index of lane held by the owner of each allocated lane
+  object_ix *owners_[lanes_count];
+  // number of allocated lanes
+  unsigned lanes_len_ = 0;
+
+public:
+  // allocates a lane with all values 0 and writes its index to 'owner'
+  // note. 'owner' is updated when the lane moves at 'free(...)'
+  void allocate(object_ix &owner) {
+    if (lanes_len_ == lanes_count) {
+      Serial.printf("!!! kinematics: could not allocate lane\n");
+      while (true)
+        ;
+    }
+    const unsigned ix = lanes_len_;
+    lanes_len_++;
+    ddx[ix] = dx[ix] = x[ix] = 0;
+    ddy[ix] = dy[ix] = y[ix] = 0;
+    prv_x[ix] = prv_y[ix] = 0;
+    owners_[ix] = &owner;
+    owner = object_ix(ix);
+  }
+
+  // frees lane 'ix' by moving the last lane to it
+  void free(const unsigned ix) {
+    lanes_len_--;
+    const unsigned last = lanes_len_;
+    if (ix == last) {
+      return;
+    }
+    ddx[ix] = ddx[last];
+    dx[ix] = dx[last];
+    x[ix] = x[last];
+    ddy[ix] = ddy[last];
+    dy[ix] = dy[last];
+    y[ix] = y[last];
+    prv_x[ix] = prv_x[last];
+    prv_y[ix] = prv_y[last];
+    owners_[ix] = owners_[last];
+    *owners_[ix] = object_ix(ix);
+  }
+
+  // saves previous position and integrates velocity and position of the
+  // allocated lanes
+  // note. loop without branches over arrays for the compiler to vectorize
+  void update(const float dt) {
+    const unsigned n = lanes_len_;
+    for (unsigned i = 0; i < n; i++) {
+      prv_x[i] = x[i];
+      prv_y[i] = y[i];
+    }
+    for (unsigned i = 0; i < n; i++) {
+      dx[i] += ddx[i] * dt;
+      x[i] += dx[i] * dt;
+    }
+    for (unsigned i = 0; i < n; i++) {
+      dy[i] += ddy[i] * dt;
+      y[i] += dy[i] * dt;
+    }
+  }
+} static kinematics{};
+
+// uniform grid of object positions for queries of objects in an area when
+// 'engine_object_grid'
+// note. objects add their position during 'objects.pre_render()' and the grid
+//       is valid until next frame, thus queries during 'update()' see the
+//       positions at previous frame
+// note. objects outside the grid are in a cell of their own, after the cells of
+//       the grid, visited only by queries extending outside the grid
+class object_grid {
+  // cells of 32 x 32 pixels
+  static constexpr unsigned cell_shift = 5;
+  static constexpr unsigned cols = (display_width + 31) >> cell_shift;
+  static constexpr unsigned rows = (display_height + 31) >> cell_shift;
+  static constexpr unsigned cells_count = cols * rows;
+  // cell of objects outside the grid
+  static constexpr unsigned outside = cells_count;
+  // size of the grid in pixels
+  static constexpr float width = float(cols << cell_shift);
+  static constexpr float height = float(rows << cell_shift);
+
+  // number of entries, 1 when not used
+  static constexpr unsigned entries_count =
+      engine_object_grid ? objects_count : 1;
+
+  class entry {
+  public:
+    object *obj;
+    float x;
+    float y;
+    unsigned cell;
+  };
+
+  entry entries_[entries_count];
+  unsigned entries_len_ = 0;
+  // indexes in 'entries_' sorted by cell
+  object_ix sorted_[entries_count];
+  // index in 'sorted_' of first entry in cell, including 'outside', and end of
+  // last cell
+  unsigned cell_bgn_[cells_count + 2]{};
+
+  // returns the column or row of 'v' clamped to the grid
+  static auto clamp(const float v, const unsigned n) -> unsigned {
+    if (v < 0) {
+      return 0;
+    }
+    const unsigned i = unsigned(v) >> cell_shift;
+    return i < n ? i : n - 1;
+  }
+
+  // returns the cell of position 'x', 'y' or 'outside'
+  static auto cell_of(const float x, const float y) -> unsigned {
+    // note. written to be true for NaN
+    if (not(x >= 0 and y >= 0 and x < width and y < height)) {
+      return outside;
+    }
+    return (unsigned(y) >> cell_shift) * cols + (unsigned(x) >> cell_shift);
+  }
+
+public:
+  // called by the engine before 'objects.pre_render()'
+  void clear() { entries_len_ = 0; }
+
+  // adds 'obj' at position 'x', 'y'
+  // returns index of entry used to 'remove(...)'
+  auto add(object *obj, const float x, const float y) -> unsigned {
+    const unsigned ix = entries_len_;
+    entries_[ix] = {obj, x, y, cell_of(x, y)};
+    entries_len_++;
+    return ix;
+  }
+
+  // removes entry 'ix' of 'obj' added since last 'clear()'
+  // note. called when an object dies to not be returned by queries
+  void remove(const unsigned ix, const object *obj) {
+    if (ix < entries_len_ and entries_[ix].obj == obj) {
+      entries_[ix].obj = nullptr;
+    }
+  }
+
+  // called by the engine after 'objects.pre_render()'
+  // counting sort of entries by cell
+  void build() {
+    unsigned counts[cells_count + 1]{};
+    for (unsigned i = 0; i < entries_len_; i++) {
+      counts[entries_[i].cell]++;
+    }
+    unsigned ix = 0;
+    for (unsigned c = 0; c <= cells_count; c++) {
+      cell_bgn_[c] = ix;
+      ix += counts[c];
+      counts[c] = cell_bgn_[c];
+    }
+    cell_bgn_[cells_count + 1] = ix;
+    for (unsigned i = 0; i < entries_len_; i++) {
+      sorted_[counts[entries_[i].cell]++] = object_ix(i);
+    }
+  }
+
+  // calls 'f(obj)' for objects with position in rectangle 'x0', 'y0' to 'x1',
+  // 'y1' inclusive
+  template <typename F>
+  void query_rect(const float x0, const float y0, const float x1,
+                  const float y1, F f) const {
+    for_each_in_cells(x0, y0, x1, y1, [&](const entry &e) {
+      if (e.x >= x0 and e.x <= x1 and e.y >= y0 and e.y <= y1) {
+        f(e.obj);
+      }
+    });
+  }
+
+  // calls 'f(obj)' for objects with position within 'r' of 'x', 'y'
+  template <typename F>
+  void query_radius(const float x, const float y, const float r, F f) const {
+    const float r2 = r * r;
+    for_each_in_cells(x - r, y - r, x + r, y + r, [&](const entry &e) {
+      const float dx = e.x - x;
+      const float dy = e.y - y;
+      if (dx * dx + dy * dy <= r2) {
+        f(e.obj);
+      }
+    });
+  }
+
+  // number of positions added since last 'clear()'
+  inline auto entries_len() const -> unsigned { return entries_len_; }
+
+private:
+  // calls 'f(entry)' for entries in the cells overlapping the rectangle and,
+  // if the rectangle extends outside the grid, in cell 'outside'
+  template <typename F>
+  void for_each_in_cells(const float x0, const float y0, const float x1,
+                         const float y1, F f) const {
+    if (x1 >= 0 and y1 >= 0 and x0 < width and y0 < height) {
+      const unsigned c0 = clamp(x0, cols);
+      const unsigned c1 = clamp(x1, cols);
+      const unsigned r1 = clamp(y1, rows);
+      for (unsigned r = clamp(y0, rows); r <= r1; r++) {
+        // cells in a row are contiguous in 'sorted_'
+        for_each_in(cell_bgn_[r * cols + c0], cell_bgn_[r * cols + c1 + 1], f);
+      }
+    }
+    if (x0 < 0 or y0 < 0 or x1 >= width or y1 >= height) {
+      for_each_in(cell_bgn_[outside], cell_bgn_[outside + 1], f);
+    }
+  }
+
+  // calls 'f(entry)' for entries from index 'bgn' to 'end' in 'sorted_'
+  template <typename F>
+  void for_each_in(const unsigned bgn, const unsigned end, F &f) const {
+    for (unsigned i = bgn; i < end; i++) {
+      const entry &e = entries_[sorted_[i]];
+      if (e.obj) {
+        f(e);
+      }
+    }
+  }
+} static object_grid{};
+
+// broad phase of collision detection done before rendering
+// sprites of objects that cannot collide with another sprite on screen, by
+// collision bits or by bounding box on a coarse grid, are rendered without
+// accessing the collision map
+class collision_broad_phase {
+  // cells of 32 x 32 pixels
+  static constexpr unsigned cell_shift = 5;
+  static constexpr unsigned cols = (display_width + 31) >> cell_shift;
+  static constexpr unsigned rows = (display_height + 31) >> cell_shift;
+
+  // union of collision bits and masks of sprites overlapping a cell
+  class cell {
+  public:
+    collision_bits bits;
+    collision_bits mask;
+    uint8_t count;
+  };
+  cell cells_[rows][cols]{};
+
+  // true if sprite might collide
+  bool may_collide_[sprites_count]{};
+
+  // sets the range of cells overlapped by the on screen sprite
+  static void cells_of(const sprite *spr, unsigned &x0, unsigned &x1,
+                       unsigned &y0, unsigned &y1) {
+    x0 = spr->scr_x < 0 ? 0 : unsigned(spr->scr_x) >> cell_shift;
+    y0 = spr->scr_y < 0 ? 0 : unsigned(spr->scr_y) >> cell_shift;
+    x1 = unsigned(spr->scr_x + int16_t(sprite_width) - 1);
+    y1 = unsigned(spr->scr_y + int16_t(sprite_height) - 1);
+    x1 = (x1 < display_width ? x1 : display_width - 1) >> cell_shift;
+    y1 = (y1 < display_height ? y1 : display_height - 1) >> cell_shift;
+  }
+
+public:
+  // called every frame after 'objects.pre_render()'
+  void update() {
+    sprite *all = sprites.all_list();
+    sprite **it = sprites.allocated_list();
+    const unsigned len = sprites.allocated_list_len();
+    // union of collision bits and masks of on screen sprites
+    collision_bits all_bits = 0;
+    collision_bits all_mask = 0;
+    for (unsigned i = 0; i < len; i++) {
+      const sprite *spr = it[i];
+      if (spr->is_on_screen()) {
+        all_bits |= spr->obj->col_bits;
+        all_mask |= spr->obj->col_mask;
+      }
+    }
+    // sprites with bits that some sprite is interested in or with interest in
+    // bits of some sprite are placed in the grid
+    memset(cells_, 0, sizeof(cells_));
+    for (unsigned i = 0; i < len; i++) {
+      const sprite *spr = it[i];
+      const sprite_ix ix = sprite_ix(spr - all);
+      may_collide_[ix] = false;
+      if (not spr->is_on_screen()) {
+        continue;
+      }
+      const object *obj = spr->obj;
+      if (not(obj->col_bits & all_mask) and not(obj->col_mask & all_bits)) {
+        continue;
+      }
+      may_collide_[ix] = true;
+      unsigned x0, x1, y0, y1;
+      cells_of(spr, x0, x1, y0, y1);
+      for (unsigned y = y0; y <= y1; y++) {
+        for (unsigned x = x0; x <= x1; x++) {
+          cell &c = cells_[y][x];
+          c.bits |= obj->col_bits;
+          c.mask |= obj->col_mask;
+          if (c.count < 255) {
+            c.count++;
+          }
+        }
+      }
+    }
+    // sprites that are alone in their cells or not interacting with the other
+    // sprites in their cells cannot collide
+    // note. the union of a cell includes the sprite itself thus the test is
+    //       conservative
+    for (unsigned i = 0; i < len; i++) {
+      const sprite *spr = it[i];
+      const sprite_ix ix = sprite_ix(spr - all);
+      if (not may_collide_[ix]) {
+        continue;
+      }
+      const object *obj = spr->obj;
+      bool collides = false;
+      unsigned x0, x1, y0, y1;
+      cells_of(spr, x0, x1, y0, y1);
+      for (unsigned y = y0; y <= y1 and not collides; y++) {
+        for (unsigned x = x0; x <= x1; x++) {
+          const cell &c = cells_[y][x];
+          if (c.count > 1 and
+              ((obj->col_bits & c.mask) or (obj->col_mask & c.bits))) {
+            collides = true;
+            break;
+          }
+        }
+      }
+      may_collide_[ix] = collides;
+    }
+  }
+
+  // returns true if on screen sprite might collide with another sprite
+  inline auto may_collide(const sprite_ix ix) const -> bool {
+    return may_collide_[ix];
+  }
+} static collision_broad_phase{};
+
+// state of an on screen sprite used by the renderer
+// note. copied from the sprite at 'sprite_bins.build()' so that the renderer
+//       does not read sprites that game logic may modify while rendering, e.g.
+//       on the other core when 'engine_pipelined'
+class sprite_render_state {
+public:
+  // value of 'spans_row' when 'img' is not an image in 'sprite_imgs'
+  static constexpr uint16_t no_spans = 0xffff;
+
+  const uint8_t *img;
+  const uint16_t *palette;
+  int16_t scr_x;
+  int16_t scr_y;
+  // index in 'sprite_img_spans_rows' of first row of 'img' when
+  // 'render_sprite_spans'
+  uint16_t spans_row;
+  sprite_ix ix;
+  uint8_t flip;
+  bool may_collide;
+
+  // returns index in 'sprite_img_spans_rows' of first row of 'img' or
+  // 'no_spans' if 'img' is not the start of an image in 'sprite_imgs'
+  static auto spans_row_of(const uint8_t *img) -> uint16_t {
+    constexpr size_t img_size = sprite_width * sprite_height;
+    const uintptr_t offset = uintptr_t(img) - uintptr_t(sprite_imgs[0]);
+    if (offset >= sprite_imgs_count * img_size or offset % img_size) {
+      return no_spans;
+    }
+    return uint16_t(offset / sprite_width);
+  }
+};
+
+static_assert(sprite_imgs_count * sprite_height <
+                  sprite_render_state::no_spans,
+              "rows of sprite images must fit "
+              "'sprite_render_state::spans_row'");
+
+// sprites on screen grouped by horizontal bands of the screen
+// built every frame after 'collision_broad_phase.update()' so that rendering a
+// scanline visits only the sprites within the band of the scanline
+class sprite_bins {
+public:
+  // height of a band in scanlines
+  static constexpr unsigned bin_height = sprite_height;
+  static constexpr unsigned bin_height_shift = 4;
+  static constexpr unsigned bin_count =
+      (display_height + bin_height - 1) / bin_height;
+
+private:
+  // render state of on screen sprites in ascending sprite index order
+  sprite_render_state states_[sprites_count]{};
+  unsigned states_len_ = 0;
+  // bit set of the on screen sprites by sprite index
+  uint32_t on_screen_[(sprites_count + 31) / 32]{};
+  // index in 'ixs_' of the first sprite in bin, last entry is end of last bin
+  uint16_t bgn_[bin_count + 1]{};
+  // indexes in 'states_' ordered by bin
+  // note. a sprite not higher than a bin overlaps at most 2 bins
+  sprite_ix ixs_[2 * sprites_count]{};
+
+  // sets first and last bin that the on screen sprite overlaps
+  static void bins_of(const sprite_render_state &spr, unsigned &first,
+                      unsigned &last) {
+    first = spr.scr_y < 0 ? 0 : unsigned(spr.scr_y) >> bin_height_shift;
+    last = unsigned(spr.scr_y + int16_t(sprite_height) - 1);
+    if (last >= display_height) {
+      last = display_height - 1;
+    }
+    last >>= bin_height_shift;
+  }
+
+public:
+  // copies the render state of on screen sprites and counting sorts them into
+  // bins
+  // note. the sprites are copied in ascending sprite index order, not in
+  //       'allocated_list()' order which changes when any sprite is freed,
+  //       thus the draw order of overlapping sprites is stable
+  void build() {
+    sprite *all = sprites.all_list();
+    sprite **it = sprites.allocated_list();
+    const unsigned len = sprites.allocated_list_len();
+    memset(on_screen_, 0, sizeof(on_screen_));
+    for (unsigned i = 0; i < len; i++) {
+      const sprite *spr = it[i];
+      if (spr->is_on_screen()) {
+        const unsigned ix = unsigned(spr - all);
+        on_screen_[ix >> 5] |= 1u << (ix & 31);
+      }
+    }
+    states_len_ = 0;
+    for (unsigned w = 0; w < sizeof(on_screen_) / sizeof(uint32_t); w++) {
+      uint32_t bits = on_screen_[w];
+      while (bits) {
+        const unsigned ix = (w << 5) + unsigned(__builtin_ctz(bits));
+        bits &= bits - 1;
+        const sprite *spr = &all[ix];
+        sprite_render_state &st = states_[states_len_++];
+        st.img = spr->img;
+        st.palette = spr->palette ? spr->palette : palette_sprites;
+        st.scr_x = spr->scr_x;
+        st.scr_y = spr->scr_y;
+        st.spans_row = render_sprite_spans
+                           ? sprite_render_state::spans_row_of(spr->img)
+                           : sprite_render_state::no_spans;
+        st.ix = sprite_ix(ix);
+        st.flip = spr->flip;
+        st.may_collide = collision_broad_phase.may_collide(st.ix);
+      }
+    }
+    unsigned counts[bin_count]{};
+    for (unsigned i = 0; i < states_len_; i++) {
+      unsigned first = 0;
+      unsigned last = 0;
+      bins_of(states_[i], first, last);
+      for (unsigned b = first; b <= last; b++) {
+        counts[b]++;
+      }
+    }
+    // start of each bin
+    unsigned pos = 0;
+    for (unsigned b = 0; b < bin_count; b++) {
+      bgn_[b] = uint16_t(pos);
+      pos += counts[b];
+    }
+    bgn_[bin_count] = uint16_t(pos);
+    // fill bins, 'counts' reused as write position
+    for (unsigned b = 0; b < bin_count; b++) {
+      counts[b] = bgn_[b];
+    }
+    for (unsigned i = 0; i < states_len_; i++) {
+      unsigned first = 0;
+      unsigned last = 0;
+      bins_of(states_[i], first, last);
+      for (unsigned b = first; b <= last; b++) {
+        ixs_[counts[b]++] = sprite_ix(i);
+      }
+    }
+  }
+
+  // returns pointer to indexes of render states in bin that contains
+  // 'scanline_y' and sets 'len' to number of indexes
+  inline auto bin(const unsigned scanline_y, unsigned &len) const
+      -> const sprite_ix * {
+    const unsigned b = scanline_y >> bin_height_shift;
+    len = unsigned(bgn_[b + 1] - bgn_[b]);
+    return &ixs_[bgn_[b]];
+  }
+
+  // returns render state at index from 'bin(...)'
+  inline auto state(const sprite_ix i) const -> const sprite_render_state * {
+    return &states_[i];
+  }
+
+  // returns render states of the on screen sprites
+  inline auto states() const -> const sprite_render_state * { return states_; }
+
+  // returns number of on screen sprites
+  inline auto states_len() const -> unsigned { return states_len_; }
+} static sprite_bins{};
+
+// collisions between on screen sprites detected by the renderer
+// note. the renderer does not access objects. the objects and their collision
+//       bits and masks are copied at 'prepare()' and the collisions are applied
+//       to the objects at 'apply()'
+class sprite_collisions {
+  // state of objects of sprites that might collide
+  object *obj_[sprites_count]{};
+  collision_bits bits_[sprites_count]{};
+  collision_bits mask_[sprites_count]{};
+
+  // sprite that the sprite collided with or 'sprite_ix_reserved' detected by
+  // each render worker
+  sprite_ix col_with_[render_workers][sprites_count];
+
+public:
+  sprite_collisions() {
+    memset(col_with_, sprite_ix_reserved, sizeof(col_with_));
+  }
+
+  // called every frame after 'sprite_bins.build()'
+  void prepare() {
+    const sprite_render_state *st = sprite_bins.states();
+    const unsigned len = sprite_bins.states_len();
+    for (unsigned i = 0; i < len; i++, st++) {
+      if (st->may_collide) {
+        object *obj = sprites.instance(st->ix)->obj;
+        obj_[st->ix] = obj;
+        bits_[st->ix] = obj->col_bits;
+        mask_[st->ix] = obj->col_mask;
+      }
+    }
+  }
+
+  // called by render worker when sprite 'ix' writes a pixel of sprite 'other'
+  inline void on_overlap(const unsigned worker, const sprite_ix ix,
+                         const sprite_ix other) {
+    if (mask_[ix] & bits_[other]) {
+      col_with_[worker][ix] = other;
+    }
+    if (mask_[other] & bits_[ix]) {
+      col_with_[worker][other] = ix;
+    }
+  }
+
+  // sets 'col_with' of the objects that collided during render
+  // note. when 'engine_pipelined' called one frame later thus collisions of
+  //       sprites that since have been turned off or re-allocated are dropped
+  void apply() {
+    const sprite_render_state *st = sprite_bins.states();
+    const unsigned len = sprite_bins.states_len();
+    for (unsigned i = 0; i < len; i++, st++) {
+      const sprite_ix ix = st->ix;
+      for (unsigned w = 0; w < render_workers; w++) {
+        const sprite_ix other = col_with_[w][ix];
+        if (other == sprite_ix_reserved) {
+          continue;
+        }
+        col_with_[w][ix] = sprite_ix_reserved;
+        const sprite *spr = sprites.instance(ix);
+        const sprite *other_spr = sprites.instance(other);
+        if (spr->img and other_spr->img and spr->obj == obj_[ix] and
+            other_spr->obj == obj_[other]) {
+          obj_[ix]->col_with = obj_[other];
+        }
+      }
+    }
+  }
+} static sprite_collisions{};
+
+// screen rows that changed since previous frame due to sprites that moved,
+// changed image, appeared or disappeared
+// used by renderers that push only the changed parts of the screen
+class dirty_rows {
+  static constexpr unsigned words = (display_height + 31) / 32;
+  // note. size 1 when disabled to not use static ram
+  static constexpr unsigned states_count =
+      render_dirty_rows ? sprites_count : 1;
+
+  // bit per screen row
+  uint32_t rows_[words]{};
+
+  // screen state of sprite at previous frame
+  // note. 'img' is nullptr if sprite was not on screen
+  class sprite_state {
+  public:
+    const uint8_t *img;
+    const uint16_t *palette;
+    int16_t scr_x;
+    int16_t scr_y;
+    uint8_t flip;
+    bool on_screen;
+  };
+  sprite_state prv_[states_count]{};
+
+  // indexes of sprites that were on screen at previous frame
+  sprite_ix prv_on_screen_[states_count]{};
+  unsigned prv_on_screen_len_ = 0;
+
+public:
+  // marks rows 'y' to 'y + height' clipped to screen as dirty
+  void mark(const int y, const unsigned height) {
+    const int y_end = y + int(height);
+    const unsigned bgn = y < 0 ? 0 : unsigned(y);
+    const unsigned end =
+        y_end > int(display_height) ? display_height : unsigned(y_end);
+    for (unsigned r = bgn; r < end; r++) {
+      rows_[r >> 5] |= 1u << (r & 31);
+    }
+  }
+
+  // marks all rows as dirty
+  void mark_all() { memset(rows_, 0xff, sizeof(rows_)); }
+
+  // clears all rows
+  void clear() { memset(rows_, 0, sizeof(rows_)); }
+
+  // returns true if any of the rows 'y' to 'y + height' is dirty
+  auto any(const unsigned y, const unsigned height) const -> bool {
+    for (unsigned r = y; r < y + height; r++) {
+      if (rows_[r >> 5] & (1u << (r & 31))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // compares the render states of sprites with the state at previous frame
+  // and marks the rows of both previous and current position of changed
+  // sprites
+  // 'shift' is the number of rows the previous frame has been moved down on
+  // the screen, e.g. by hardware scrolling, in which case all sprites are
+  // re-rendered
+  // called every frame by the renderer
+  void update_sprites(const int shift) {
+    // sprites that moved, changed image, palette or flip, or appeared
+    const sprite_render_state *st = sprite_bins.states();
+    const unsigned len = sprite_bins.states_len();
+    for (unsigned i = 0; i < len; i++, st++) {
+      sprite_state &prv = prv_[st->ix];
+      if (shift or prv.img != st->img or prv.scr_x != st->scr_x or
+          prv.scr_y != st->scr_y or prv.palette != st->palette or
+          prv.flip != st->flip) {
+        if (prv.img) {
+          mark(prv.scr_y + shift, sprite_height);
+        }
+        mark(st->scr_y, sprite_height);
+        prv.img = st->img;
+        prv.palette = st->palette;
+        prv.scr_x = st->scr_x;
+        prv.scr_y = st->scr_y;
+        prv.flip = st->flip;
+      }
+      prv.on_screen = true;
+    }
+    // sprites that are no longer on screen
+    for (unsigned i = 0; i < prv_on_screen_len_; i++) {
+      sprite_state &prv = prv_[prv_on_screen_[i]];
+      if (not prv.on_screen) {
+        mark(prv.scr_y + shift, sprite_height);
+        prv.img = nullptr;
+      }
+    }
+    // sprites on screen at this frame
+    st = sprite_bins.states();
+    for (unsigned i = 0; i < len; i++, st++) {
+      prv_on_screen_[i] = st->ix;
+      prv_[st->ix].on_screen = false;
+    }
+    prv_on_screen_len_ = len;
+  }
+} static dirty_rows{};
+
+// forward declaration of user provided callbacks
+// calls 'objects.init(...)' with the types of the object classes
+static void main_init_objects();
+static void main_on_frame_completed();
+// calls 'objects.update_batched(...)' with the types of the object classes
+// instead of 'objects.update()' when 'engine_update_batched'
+static void main_update_objects();
+
 static void engine_setup() {
+#ifdef USE_ASSET_PACK
+  // map sprites, tiles, palettes and tile map
+  asset_pack.init();
+#endif
+
+  // copy of resources used by the renderer
+  render_init();
+
+  // allocate the pools of object classes
+  main_init_objects();
+
+  // expand the most used tiles
+  tile_cache.init();
+
   // allocate collision map
   collision_map = (sprite_ix *)malloc(collision_map_size);
   if (!collision_map) {
@@ -212,34 +1857,173 @@ static void engine_setup() {
     while (true)
       ;
   }
+  memset(collision_map, sprite_ix_reserved, collision_map_size);
 }
 
-// forward declaration of platform specific function
+// phases of 'engine_loop()'
+enum engine_phase : uint8_t {
+  phase_update,     // objects update and free
+  phase_pre_render, // objects pre-render and copy of sprite render state
+  phase_collisions, // collision broad phase, copy and apply of collisions
+  phase_render,     // render tiles, sprites and collision map
+  phase_game,       // game logic after frame
+  phase_stream,     // decompress rows of tile map around the screen
+  phase_done        // 'engine_loop()' returned
+};
+
+static constexpr unsigned engine_phases_count = phase_done + 1;
+
+// forward declaration of platform specific functions
 static void render(const unsigned x, const unsigned y);
+// starts 'render(x, y)' on the other core and returns
+static void render_start(const unsigned x, const unsigned y);
+// waits for the render started by 'render_start(...)', if any, to finish
+static void render_wait();
+// called at the start of every phase of 'engine_loop()'
+static void on_engine_phase(const engine_phase phase);
 
-// forward declaration of user provided callback
-static void main_on_frame_completed();
+// waits for the render of previous frame started on the other core and
+// applies the collisions it detected
+static void engine_render_wait() {
+  on_engine_phase(phase_render);
+  render_wait();
+  on_engine_phase(phase_collisions);
+  sprite_collisions.apply();
+  on_engine_phase(phase_update);
+}
 
 // update and render the state of the engine
+// note. when 'engine_pipelined' the previous frame is rendered on the other
+//       core during 'objects.update()' and the collisions it detected are
+//       applied one frame later
+// note. when 'engine_fixed_dt_ms' the objects are updated and game logic
+//       called 0 or more times before rendering
 static void engine_loop() {
-  // call 'update()' on allocated objects
-  objects.update();
+  // true after first simulation step when 'engine_fixed_dt_ms'
+  static bool stepped = false;
+
+  on_engine_phase(phase_update);
+
+  // simulation steps, always 1 unless 'engine_fixed_dt_ms'
+  for (unsigned step = 0; step < clk.steps; step++) {
+    if (engine_fixed_dt_ms) {
+      clk.on_step();
+      tile_map_prv_x = tile_map_x;
+      tile_map_prv_y = tile_map_y;
+      stepped = true;
+    }
+
+    if (engine_kinematics_soa) {
+      kinematics.update(clk.dt);
+    }
+
+    // call 'update()' on allocated objects
+    if (engine_update_batched) {
+      main_update_objects();
+    } else {
+      objects.update();
+    }
+
+    if (engine_pipelined and step == 0) {
+      engine_render_wait();
+    }
+
+    // deallocate the objects freed during 'objects.update()'
+    objects.apply_free();
+
+    // deallocate the sprites freed during 'objects.update()'
+    sprites.apply_free();
 
-  // deallocate the objects freed during 'objects.update()'
-  objects.apply_free();
+    if (engine_fixed_dt_ms) {
+      // game logic hook
+      on_engine_phase(phase_game);
+      main_on_frame_completed();
+      on_engine_phase(phase_update);
+    }
+  }
+
+  if (engine_pipelined and clk.steps == 0) {
+    engine_render_wait();
+  }
 
-  // deallocate the sprites freed during 'objects.update()'
-  sprites.apply_free();
+  on_engine_phase(phase_collisions);
 
   // clear collisions map
-  memset(collision_map, sprite_ix_reserved, collision_map_size);
+  // note. if the collision map is a band it is cleared by the renderer before
+  //       every row of tiles
+  if (not collision_map_band) {
+    collision_map_clear();
+  }
+
+  on_engine_phase(phase_pre_render);
+
+  // select the frames of animated tiles
+  if (tile_anims_count) {
+    tile_remap.update(clk.ms);
+  }
+
+  // rows of tiles written since previous frame become dirty
+  if (tile_map_ram_rows) {
+    tile_map_overlay.on_render();
+  }
 
   // prepare objects for render
+  if (engine_object_grid) {
+    object_grid.clear();
+  }
   objects.pre_render();
+  if (engine_object_grid) {
+    object_grid.build();
+  }
+
+  on_engine_phase(phase_collisions);
 
-  // render tiles, sprites and collision map
-  render(unsigned(tile_map_x), unsigned(tile_map_y));
+  // find the sprites that might collide
+  collision_broad_phase.update();
 
-  // game logic hook
-  main_on_frame_completed();
-}
\ No newline at end of file
+  on_engine_phase(phase_pre_render);
+
+  // copy render state of on screen sprites grouped by the screen bands they
+  // are on
+  sprite_bins.build();
+
+  on_engine_phase(phase_collisions);
+
+  // copy collision state of the objects of the sprites that might collide
+  sprite_collisions.prepare();
+
+  on_engine_phase(phase_render);
+
+  // tile map position interpolated between the two last steps
+  float x = tile_map_x;
+  float y = tile_map_y;
+  if (engine_fixed_dt_ms and stepped) {
+    x = tile_map_prv_x + (tile_map_x - tile_map_prv_x) * clk.alpha;
+    y = tile_map_prv_y + (tile_map_y - tile_map_prv_y) * clk.alpha;
+  }
+
+  // decompress the rows of tiles scrolled into the ring
+  if (tile_map_stream_rows) {
+    on_engine_phase(phase_stream);
+    tile_map_stream.update(unsigned(y) >> tile_height_shift);
+    on_engine_phase(phase_render);
+  }
+
+  if (engine_pipelined) {
+    // render tiles, sprites and collision map on the other core
+    render_start(unsigned(x), unsigned(y));
+  } else {
+    // render tiles, sprites and collision map
+    render(unsigned(x), unsigned(y));
+    on_engine_phase(phase_collisions);
+    sprite_collisions.apply();
+  }
+
+  if (not engine_fixed_dt_ms) {
+    // game logic hook
+    on_engine_phase(phase_game);
+    main_on_frame_completed();
+  }
+
+  on_engine_phase(phase_done);
+}
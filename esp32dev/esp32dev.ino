@@ -71,12 +71,71 @@
 #include <TFT_eSPI.h>
 #include <XPT2046_Touchscreen.h>
 
+// platform independent rendering of scanlines
+#include "renderer.hpp"
+
+// record cpu cycles spent in the phases of 'engine_loop()' and rendering bands
+// in 'profiler', print statistics with frames per second and dump the
+// recorded frames in binary when 'p' is received on serial
+// note. decoded by 'utils/profiler/decode-profile.py'
+// note. defined before 'profiler.hpp' that allocates the frames only if enabled
+static constexpr bool profiler_enabled = false;
+
+// frame profiler
+#include "profiler.hpp"
+
+#include <atomic>
+
 // #define USE_WIFI
 #ifdef USE_WIFI
 #include "WiFi.h"
 #include "secrets.h"
 #endif
 
+#ifdef USE_ASSET_PACK
+#include <esp_partition.h>
+
+// maps the asset pack written raw in the spiffs data partition
+// note. files in spiffs or littlefs are not contiguous in flash thus cannot be
+//       memory mapped
+// note. maps only the size of the pack, read from the header, rounded up to
+//       the mmu page size since the data mmu has few pages and the partition
+//       is larger than the pack
+static auto asset_pack_map(uint32_t &size) -> const uint8_t * {
+  const esp_partition_t *part = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, nullptr);
+  if (!part) {
+    return nullptr;
+  }
+  // map the first page to read the size of the pack at offset 8 of the header
+  const void *ptr = nullptr;
+  spi_flash_mmap_handle_t handle;
+  if (esp_partition_mmap(part, 0, SPI_FLASH_MMU_PAGE_SIZE, SPI_FLASH_MMAP_DATA,
+                         &ptr, &handle) != ESP_OK) {
+    return nullptr;
+  }
+  uint32_t pack_size = 0;
+  memcpy(&pack_size, (const uint8_t *)ptr + 8, sizeof(pack_size));
+  spi_flash_munmap(handle);
+  // note. a size larger than the partition, e.g. erased flash, maps the first
+  //       page and the header is rejected by 'asset_pack::init()'
+  uint32_t map_size = SPI_FLASH_MMU_PAGE_SIZE;
+  if (pack_size <= part->size) {
+    map_size = (pack_size + SPI_FLASH_MMU_PAGE_SIZE - 1) &
+               ~uint32_t(SPI_FLASH_MMU_PAGE_SIZE - 1);
+    if (map_size > part->size) {
+      map_size = part->size;
+    }
+  }
+  if (esp_partition_mmap(part, 0, map_size, SPI_FLASH_MMAP_DATA, &ptr,
+                         &handle) != ESP_OK) {
+    return nullptr;
+  }
+  size = map_size;
+  return (const uint8_t *)ptr;
+}
+#endif
+
 // rgb led
 static constexpr uint8_t cyd_led_blue = 17;
 static constexpr uint8_t cyd_led_red = 4;
@@ -98,215 +157,414 @@ static SPIClass spi{HSPI};
 static XPT2046_Touchscreen touch_screen{xpt2046_cs, xpt2046_irq};
 static TFT_eSPI display{};
 
-// buffers for rendering a chunk while the other is transferred to the screen
-// using DMA. allocated in setup
-static uint16_t *dma_buf_1;
-static uint16_t *dma_buf_2;
+// buffers for rendering a chunk while the others are transferred to the
+// screen using DMA. allocated in setup
+// note. 'render_parallel_bands' uses a ring of 4 buffers so that both workers
+//       can render while a buffer is transferred
+static constexpr unsigned dma_bufs_count = render_parallel_bands ? 4 : 2;
+static uint16_t *dma_bufs[dma_bufs_count];
 static constexpr unsigned dma_buf_size =
     sizeof(uint16_t) * display_width * tile_height;
 
-// clang-format off
-// note. not formatted because compiler gets confused and issues invalid error
-static void render_scanline(
-    uint16_t *render_buf_ptr,
-    sprite_ix *collision_map_scanline_ptr,
-    const int16_t scanline_y,
-    const unsigned tile_x,
-    const unsigned tile_dx,
-    const unsigned tile_width_minus_dx,
-    const tile_ix *tiles_map_row_ptr,
-    const unsigned tile_sub_y,
-    const unsigned tile_sub_y_times_tile_width
-) {
-  // clang-format on
-  // used later by sprite renderer to overwrite tiles pixels
-  uint16_t *scanline_ptr = render_buf_ptr;
-
-  if (tile_width_minus_dx) {
-    // render first partial tile
-    const tile_ix tile_index = *(tiles_map_row_ptr + tile_x);
-    const uint8_t *tile_data_ptr =
-        tiles[tile_index].data + tile_sub_y_times_tile_width + tile_dx;
-    for (unsigned i = tile_dx; i < tile_width; i++) {
-      *render_buf_ptr++ = palette_tiles[*tile_data_ptr++];
-    }
+// measure time spent rasterizing bands versus transferring them to the screen
+// printed with frames per second
+// note. waits for every DMA transfer to finish to time it thus the transfer
+//       does not overlap the rendering of the next band on the same core
+static constexpr bool render_bench = false;
+
+// ILI9341 commands defining the vertical scrolling area and the display
+// memory row shown at the top of the screen
+static constexpr uint8_t ili9341_vscrdef = 0x33;
+static constexpr uint8_t ili9341_vscrsadd = 0x37;
+
+static_assert(not render_hw_vscroll or
+                  (render_dirty_rows and display_orientation == 0),
+              "'render_hw_vscroll' requires 'render_dirty_rows' and portrait "
+              "orientation");
+
+// display memory row shown at top of screen when 'render_hw_vscroll'
+static unsigned display_scroll_top = 0;
+
+// sends 16-bit command parameter to display
+static void display_write_data16(const unsigned data) {
+  display.writedata(uint8_t(data >> 8));
+  display.writedata(uint8_t(data));
+}
+
+// defines the whole screen as vertical scrolling area
+static void display_init_vscroll() {
+  display.startWrite();
+  display.writecommand(ili9341_vscrdef);
+  display_write_data16(0); // top fixed area
+  display_write_data16(display_height); // vertical scrolling area
+  display_write_data16(0); // bottom fixed area
+  display.writecommand(ili9341_vscrsadd);
+  display_write_data16(display_scroll_top);
+  display.endWrite();
+}
+
+// scanlines of a row of tiles on screen rendered into one DMA buffer
+class render_band {
+public:
+  // row in tile map
+  const tile_ix *tiles_map_row_ptr;
+  // first scanline on screen
+  unsigned frame_y;
+  // first scanline in the row of tiles, not 0 if first band is partial
+  unsigned tile_sub_y;
+  // number of scanlines
+  unsigned height;
+};
+
+// bands of the frame being rendered
+// note. shared with the band worker task when 'render_parallel_bands'
+class render_frame {
+public:
+  // maximum number of bands, first and last may be partial
+  static constexpr unsigned bands_max = display_height / tile_height + 1;
+
+  unsigned tile_x = 0;
+  unsigned tile_dx = 0;
+  unsigned tile_width_minus_dx = 0;
+  render_band bands[bands_max]{};
+  unsigned bands_len = 0;
+} static render_frame{};
+
+// accumulated times since the last print when 'render_bench'
+class render_bench_stats {
+public:
+  unsigned long raster_us[render_workers]{};
+  unsigned bands[render_workers]{};
+  unsigned long dma_us = 0;
+  unsigned dma_bands = 0;
+} static render_bench_stats{};
+
+// renders band 'k' of 'render_frame' to 'buf' using the collision map of
+// 'worker'
+static void render_band_rasterize(const unsigned k, uint16_t *buf,
+                                  const unsigned worker) {
+  const unsigned long t0 = render_bench ? micros() : 0;
+  const uint32_t c0 = profiler_enabled ? ESP.getCycleCount() : 0;
+  const render_band &band = render_frame.bands[k];
+  // pointer to collision map starting at first scanline of band
+  sprite_ix *collision_map_scanline_ptr = collision_map_of(worker);
+  if (collision_map_band) {
+    collision_map_clear(worker);
+  } else {
+    collision_map_scanline_ptr += band.frame_y * display_width;
   }
-  // render full tiles
-  const unsigned tx_max = tile_x + (display_width / tile_width);
-  for (unsigned tx = tile_x + 1; tx < tx_max; tx++) {
-    const tile_ix tile_index = *(tiles_map_row_ptr + tx);
-    const uint8_t *tile_data_ptr =
-        tiles[tile_index].data + tile_sub_y_times_tile_width;
-    for (unsigned i = 0; i < tile_width; i++) {
-      *render_buf_ptr++ = palette_tiles[*tile_data_ptr++];
-    }
+  // render the scanlines from tiles map and sprites to 'buf'
+  int16_t scanline_y = int16_t(band.frame_y);
+  for (unsigned sub_y = band.tile_sub_y,
+                tile_sub_y_times_tile_width = band.tile_sub_y * tile_width;
+       sub_y < band.tile_sub_y + band.height;
+       sub_y++, tile_sub_y_times_tile_width += tile_width,
+                buf += display_width,
+                collision_map_scanline_ptr += display_width, scanline_y++) {
+
+    render_scanline(buf, collision_map_scanline_ptr, scanline_y,
+                    render_frame.tile_x, render_frame.tile_dx,
+                    render_frame.tile_width_minus_dx, band.tiles_map_row_ptr,
+                    sub_y, tile_sub_y_times_tile_width, worker);
   }
-  if (tile_dx) {
-    // render last partial tile
-    const tile_ix tile_index = *(tiles_map_row_ptr + tx_max);
-    const uint8_t *tile_data_ptr =
-        tiles[tile_index].data + tile_sub_y_times_tile_width;
-    for (unsigned i = 0; i < tile_dx; i++) {
-      *render_buf_ptr++ = palette_tiles[*tile_data_ptr++];
-    }
+  if (profiler_enabled) {
+    profiler.on_raster(worker, ESP.getCycleCount() - c0);
   }
+  if (render_bench) {
+    render_bench_stats.raster_us[worker] += micros() - t0;
+    render_bench_stats.bands[worker]++;
+  }
+}
 
-  // render sprites
-  // note. although grossly inefficient algorithm the DMA is busy while
-  // rendering one tile height of sprites and tiles
+// starts DMA transfer of band 'k' of 'render_frame' rendered in 'buf'
+// note. waits for the previous transfer to finish
+static void render_band_push(const unsigned k, uint16_t *buf) {
+  const unsigned long t0 = render_bench ? micros() : 0;
+  const uint32_t c0 = profiler_enabled ? ESP.getCycleCount() : 0;
+  const render_band &band = render_frame.bands[k];
+  // display memory row of the band wraps around when hardware scrolling
+  const unsigned mem_y = (display_scroll_top + band.frame_y) % display_height;
+  if (mem_y + band.height <= display_height) {
+    display.setAddrWindow(0, int32_t(mem_y), display_width,
+                          int32_t(band.height));
+    display.pushPixelsDMA(buf, display_width * band.height);
+  } else {
+    const unsigned first_height = display_height - mem_y;
+    display.setAddrWindow(0, int32_t(mem_y), display_width,
+                          int32_t(first_height));
+    display.pushPixelsDMA(buf, display_width * first_height);
+    display.setAddrWindow(0, 0, display_width,
+                          int32_t(band.height - first_height));
+    display.pushPixelsDMA(buf + display_width * first_height,
+                          display_width * (band.height - first_height));
+  }
+  if (profiler_enabled) {
+    profiler.on_push(ESP.getCycleCount() - c0);
+  }
+  if (render_bench) {
+    display.dmaWait();
+    render_bench_stats.dma_us += micros() - t0;
+    render_bench_stats.dma_bands++;
+  }
+}
 
-  sprite *spr = sprites.all_list();
-  const unsigned len = sprites.all_list_len();
-  for (unsigned i = 0; i < len; i++, spr++) {
-    if (!spr->img or spr->scr_y > scanline_y or
-        spr->scr_y + int16_t(sprite_height) <= scanline_y or
-        spr->scr_x <= sprite_width_neg or spr->scr_x > int16_t(display_width)) {
-      // sprite has no image or
-      // not within scanline or
-      // is outside the screen x-wise
-      continue;
+// band worker task on core 0 when 'render_parallel_bands'
+static TaskHandle_t render_worker_handle = nullptr;
+// task rendering and pushing the bands
+static TaskHandle_t render_pusher_handle = nullptr;
+// incremented when a frame is started
+static std::atomic<unsigned> render_bands_frame{0};
+// number of bands rendered by the worker in current frame
+static std::atomic<unsigned> render_bands_rendered{0};
+// number of bands in current frame whose transfer has been started
+static std::atomic<unsigned> render_bands_pushed{0};
+
+// renders the odd bands of every frame
+// note. band 'k' is rendered to buffer 'k % dma_bufs_count' after the transfer
+//       of band 'k - dma_bufs_count' has finished which is when the transfer
+//       of the next band has been started
+static void render_worker_task(void *) {
+  unsigned frame = 0;
+  while (true) {
+    while (render_bands_frame.load() == frame) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
     }
-    const uint8_t *spr_data_ptr =
-        spr->img + (scanline_y - spr->scr_y) * sprite_width;
-    uint16_t *scanline_dst_ptr = scanline_ptr + spr->scr_x;
-    unsigned render_width = sprite_width;
-    sprite_ix *collision_pixel = collision_map_scanline_ptr + spr->scr_x;
-    if (spr->scr_x < 0) {
-      // adjustment if x is negative
-      spr_data_ptr -= spr->scr_x;
-      scanline_dst_ptr -= spr->scr_x;
-      render_width = sprite_width + spr->scr_x;
-      collision_pixel -= spr->scr_x;
-    } else if (spr->scr_x + sprite_width > display_width) {
-      // adjustment if sprite partially outside screen (x-wise)
-      render_width = display_width - spr->scr_x;
+    frame = render_bands_frame.load();
+    for (unsigned k = 1; k < render_frame.bands_len; k += render_workers) {
+      while (k >= dma_bufs_count and
+             render_bands_pushed.load() < k - dma_bufs_count + 2) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      }
+      render_band_rasterize(k, dma_bufs[k % dma_bufs_count], 1);
+      render_bands_rendered.store(k + 1);
+      xTaskNotifyGive(render_pusher_handle);
     }
-    // render scanline of sprite
-    object *obj = spr->obj;
-    for (unsigned j = 0; j < render_width;
-         j++, collision_pixel++, scanline_dst_ptr++) {
-      // write pixel from sprite data or skip if 0
-      const uint8_t color_ix = *spr_data_ptr++;
-      if (color_ix) {
-        *scanline_dst_ptr = palette_sprites[color_ix];
-        if (*collision_pixel != sprite_ix_reserved) {
-          sprite *spr2 = sprites.instance(*collision_pixel);
-          object *other_obj = spr2->obj;
-          if (obj->col_mask & other_obj->col_bits) {
-            obj->col_with = other_obj;
-          }
-          if (other_obj->col_mask & obj->col_bits) {
-            other_obj->col_with = obj;
-          }
-        }
-        // set pixel collision value to sprite index
-        *collision_pixel = i;
+  }
+}
+
+// renders the even bands and pushes all bands in order while the worker task
+// renders the odd bands
+static void render_bands_parallel() {
+  // buffers are free when the transfer of previous frame has finished
+  display.dmaWait();
+  render_pusher_handle = xTaskGetCurrentTaskHandle();
+  render_bands_rendered.store(0);
+  render_bands_pushed.store(0);
+  render_bands_frame.fetch_add(1);
+  xTaskNotifyGive(render_worker_handle);
+  for (unsigned k = 0; k < render_frame.bands_len; k++) {
+    uint16_t *buf = dma_bufs[k % dma_bufs_count];
+    if (k % render_workers == 0) {
+      render_band_rasterize(k, buf, 0);
+    } else {
+      while (render_bands_rendered.load() < k + 1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
       }
     }
+    render_band_push(k, buf);
+    render_bands_pushed.store(k + 1);
+    xTaskNotifyGive(render_worker_handle);
   }
 }
 
 // buffer: one tile height, palette, 8-bit tiles from tiles map, 8-bit sprites
 // 31 fps with DMA, 22 fps without
 static void render(const unsigned x, const unsigned y) {
+  // when 'engine_pipelined' the frame is captured at 'render_start()'
+  if (profiler_enabled and not engine_pipelined) {
+    profiler.on_render_start();
+  }
+  // tile map position at previous frame used to decide if the whole screen
+  // must be rendered
+  static unsigned prv_x = 0;
+  static unsigned prv_y = 0;
+  static bool prv_rendered = false;
+
+  // scroll the display memory when the tile map moved only vertically and
+  // render only the newly exposed rows and the rows of sprites
+  const bool scroll = render_hw_vscroll and prv_rendered and x == prv_x and
+                      y != prv_y and y + display_height > prv_y and
+                      prv_y + display_height > y;
+  // number of rows the previous frame moves down on screen
+  const int shift = scroll ? int(prv_y) - int(y) : 0;
+
+  // render all rows unless rendering only the dirty rows and the tile map has
+  // not moved, or has been scrolled, since previous frame
+  const bool render_all = not render_dirty_rows or not prv_rendered or
+                          (not scroll and (x != prv_x or y != prv_y));
+  prv_x = x;
+  prv_y = y;
+  prv_rendered = true;
+
+  if (render_dirty_rows) {
+    dirty_rows.update_sprites(shift);
+  }
+
   display.startWrite();
 
-  const unsigned tile_x = x >> tile_width_shift;
-  const unsigned tile_dx = x & tile_width_and;
-  const unsigned tile_width_minus_dx = tile_width - tile_dx;
-  unsigned tile_y = y >> tile_height_shift;
+  if (scroll) {
+    // wait for previous frame DMA transfer to finish before sending commands
+    display.dmaWait();
+    display_scroll_top =
+        unsigned(int(display_scroll_top) - shift + int(display_height)) %
+        display_height;
+    display.writecommand(ili9341_vscrsadd);
+    display_write_data16(display_scroll_top);
+    // mark the exposed rows at top or bottom of the screen
+    if (shift > 0) {
+      dirty_rows.mark(0, unsigned(shift));
+    } else {
+      dirty_rows.mark(int(display_height) + shift, unsigned(-shift));
+    }
+  }
+
+  render_frame.tile_x = x >> tile_width_shift;
+  render_frame.tile_dx = x & tile_width_and;
+  render_frame.tile_width_minus_dx = tile_width - render_frame.tile_dx;
+  const unsigned tile_y = y >> tile_height_shift;
   const unsigned tile_dy = y & tile_height_and;
-  const unsigned tile_y_max = tile_y + (display_height / tile_height);
-  const unsigned tile_height_minus_dy = tile_height - tile_dy;
 
-  // selects buffer to write while DMA reads the other buffer
-  bool dma_buf_use_first = true;
-  // y in frame for current tiles row to be copied by DMA
+  // current row of tiles
+  unsigned tile_row = tile_y;
+  // number of tiles in a row on screen including partial tiles
+  const unsigned tiles_on_screen =
+      display_width / tile_width + (render_frame.tile_dx ? 1 : 0);
+  // first scanline in current row of tiles, partial if 'tile_dy' is not 0
+  unsigned tile_sub_y = tile_dy;
+  // y on screen for current row of tiles
   unsigned frame_y = 0;
-  // current line y on screen
-  int16_t scanline_y = 0;
-  // pointer to start of current row of tiles
-  const tile_ix *tiles_map_row_ptr = tile_map.cell[tile_y];
-  // pointer to collision map starting at top left of screen
-  sprite_ix *collision_map_scanline_ptr = collision_map;
-  if (tile_dy) {
-    // render the partial top tile
-    // swap between two rendering buffers to not overwrite DMA accessed
-    // buffer
-    uint16_t *render_buf_ptr = dma_buf_use_first ? dma_buf_1 : dma_buf_2;
-    dma_buf_use_first = not dma_buf_use_first;
-    // pointer to the buffer that the DMA will copy to screen
-    uint16_t *dma_buf = render_buf_ptr;
-    // render scanlines of first partial tile
-    for (unsigned tile_sub_y = tile_dy,
-                  tile_sub_y_times_tile_width = tile_dy * tile_width;
-         tile_sub_y < tile_height;
-         tile_sub_y++, tile_sub_y_times_tile_width += tile_width,
-                  render_buf_ptr += display_width,
-                  collision_map_scanline_ptr += display_width, scanline_y++) {
-
-      render_scanline(render_buf_ptr, collision_map_scanline_ptr, scanline_y,
-                      tile_x, tile_dx, tile_width_minus_dx, tiles_map_row_ptr,
-                      tile_sub_y, tile_sub_y_times_tile_width);
+  // bands to render, one for each row of tiles on screen, first and last may
+  // be partial
+  render_frame.bands_len = 0;
+  while (frame_y < display_height) {
+    unsigned band_height = tile_height - tile_sub_y;
+    if (frame_y + band_height > display_height) {
+      band_height = display_height - frame_y;
     }
-
-    display.setAddrWindow(0, frame_y, display_width, tile_height_minus_dy);
-    display.pushPixelsDMA(dma_buf, display_width * tile_height_minus_dy);
-
-    tile_y++;
-    tiles_map_row_ptr += tile_map_width;
-    frame_y += tile_height_minus_dy;
-  }
-  // for each row of full tiles
-  for (; tile_y < tile_y_max;
-       tile_y++, frame_y += tile_height, tiles_map_row_ptr += tile_map_width) {
-    // swap between two rendering buffers to not overwrite DMA accessed
-    // buffer
-    uint16_t *render_buf_ptr = dma_buf_use_first ? dma_buf_1 : dma_buf_2;
-    dma_buf_use_first = not dma_buf_use_first;
-    // pointer to the buffer that the DMA will copy to screen
-    uint16_t *dma_buf = render_buf_ptr;
-    // render one tile height of pixels from tiles map and sprites to the
-    // 'render_buf_ptr'
-    for (unsigned tile_sub_y = 0, tile_sub_y_times_tile_width = 0;
-         tile_sub_y < tile_height;
-         tile_sub_y++, tile_sub_y_times_tile_width += tile_height,
-                  render_buf_ptr += display_width,
-                  collision_map_scanline_ptr += display_width, scanline_y++) {
-
-      render_scanline(render_buf_ptr, collision_map_scanline_ptr, scanline_y,
-                      tile_x, tile_dx, tile_width_minus_dx, tiles_map_row_ptr,
-                      tile_sub_y, tile_sub_y_times_tile_width);
+    // pointer to start of current row of tiles, in flash or in ram if modified
+    const tile_ix *tiles_map_row_ptr = tile_map_overlay.row(tile_row);
+    if (render_all or dirty_rows.any(frame_y, band_height) or
+        tile_map_overlay.is_dirty(tile_row) or
+        (tile_anims_count and
+         tile_remap.row_changed(tiles_map_row_ptr + render_frame.tile_x,
+                                tiles_on_screen))) {
+      render_band &band = render_frame.bands[render_frame.bands_len++];
+      band.tiles_map_row_ptr = tiles_map_row_ptr;
+      band.frame_y = frame_y;
+      band.tile_sub_y = tile_sub_y;
+      band.height = band_height;
     }
+    frame_y += band_height;
+    tile_sub_y = 0;
+    tile_row++;
+  }
 
-    display.setAddrWindow(0, frame_y, display_width, tile_height);
-    display.pushPixelsDMA(dma_buf, display_width * tile_height);
-  }
-  if (tile_dy) {
-    // render last partial tile
-    // swap between two rendering buffers to not overwrite DMA accessed
-    // buffer
-    uint16_t *render_buf_ptr = dma_buf_use_first ? dma_buf_1 : dma_buf_2;
-    dma_buf_use_first = not dma_buf_use_first;
-    // pointer to the buffer that the DMA will copy to screen
-    uint16_t *dma_buf = render_buf_ptr;
-    // render the partial last tile row
-    for (unsigned tile_sub_y = 0, tile_sub_y_times_tile_width = 0;
-         tile_sub_y < tile_dy;
-         tile_sub_y++, tile_sub_y_times_tile_width += tile_width,
-                  render_buf_ptr += display_width,
-                  collision_map_scanline_ptr += display_width, scanline_y++) {
-
-      render_scanline(render_buf_ptr, collision_map_scanline_ptr, scanline_y,
-                      tile_x, tile_dx, tile_width_minus_dx, tiles_map_row_ptr,
-                      tile_sub_y, tile_sub_y_times_tile_width);
+  if (render_parallel_bands) {
+    render_bands_parallel();
+  } else {
+    // cycle through buffers to not overwrite DMA accessed buffer
+    for (unsigned k = 0; k < render_frame.bands_len; k++) {
+      uint16_t *buf = dma_bufs[k % dma_bufs_count];
+      render_band_rasterize(k, buf, 0);
+      render_band_push(k, buf);
     }
-
-    display.setAddrWindow(0, frame_y, display_width, tile_dy);
-    display.pushPixelsDMA(dma_buf, display_width * tile_dy);
   }
 
   display.endWrite();
+
+  if (render_dirty_rows) {
+    dirty_rows.clear();
+  }
+}
+
+// render task on core 0 when 'engine_pipelined'
+static TaskHandle_t render_task_handle = nullptr;
+// task waiting for the render to finish
+static TaskHandle_t render_caller_handle = nullptr;
+// tile map position of the frame being rendered
+static unsigned render_task_x = 0;
+static unsigned render_task_y = 0;
+// true if a render has been started and not waited for
+static bool render_task_busy = false;
+
+static void render_task(void *) {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    render(render_task_x, render_task_y);
+    xTaskNotifyGive(render_caller_handle);
+  }
+}
+
+static void render_start(const unsigned x, const unsigned y) {
+  if (profiler_enabled) {
+    profiler.on_render_start();
+  }
+  render_task_x = x;
+  render_task_y = y;
+  render_task_busy = true;
+  render_caller_handle = xTaskGetCurrentTaskHandle();
+  xTaskNotifyGive(render_task_handle);
+}
+
+static void render_wait() {
+  if (render_task_busy) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    render_task_busy = false;
+  }
+}
+
+static auto engine_ticks() -> uint32_t { return ESP.getCycleCount(); }
+
+static void on_engine_phase(const engine_phase phase) {
+  if (profiler_enabled) {
+    profiler.on_phase(phase, ESP.getCycleCount());
+  }
+}
+
+// prints minimum, average and 99th percentile of the frames in 'profiler'
+static void profiler_print() {
+  const uint32_t ticks_per_us = ESP.getCpuFreqMHz();
+  Serial.printf("  %-12s %8s %8s %8s (us, %u frames)\n", "phase", "min", "avg",
+                "p99", profiler.frames_len());
+  for (unsigned p = 0; p < engine_phases_count; p++) {
+    const profiler::stats st = profiler.stats_of(
+        [p](const profiler::frame &f) { return f.phase[p]; });
+    Serial.printf("  %-12s %8u %8u %8u\n", profiler_phase_names[p],
+                  st.min / ticks_per_us, st.avg / ticks_per_us,
+                  st.p99 / ticks_per_us);
+  }
+  for (unsigned w = 0; w < render_workers; w++) {
+    const profiler::stats st = profiler.stats_of(
+        [w](const profiler::frame &f) { return f.raster[w]; });
+    Serial.printf("  raster %-5u %8u %8u %8u\n", w, st.min / ticks_per_us,
+                  st.avg / ticks_per_us, st.p99 / ticks_per_us);
+  }
+  const profiler::stats st =
+      profiler.stats_of([](const profiler::frame &f) { return f.dma_wait; });
+  Serial.printf("  %-12s %8u %8u %8u\n", "dma wait", st.min / ticks_per_us,
+                st.avg / ticks_per_us, st.p99 / ticks_per_us);
+}
+
+// prints 'object_class_stats' as updates and microseconds in 'update()' per
+// frame and allocations and frees since previous print then clears it
+static void object_class_stats_print() {
+  const uint32_t ticks_per_us = ESP.getCpuFreqMHz();
+  const unsigned frames = object_class_stats.frames;
+  if (frames == 0) {
+    return;
+  }
+  Serial.printf("  %-16s %8s %8s %8s %8s (%u frames)\n", "class", "upd/frm",
+                "us/frm", "allocs", "frees", frames);
+  for (unsigned c = 0; c < object_class_count; c++) {
+    const object_class_stats::entry &e = object_class_stats.of_class[c];
+    if (e.updates == 0 and e.allocs == 0) {
+      continue;
+    }
+    Serial.printf("  %-16s %8u %8u %8u %8u\n", object_class_names[c],
+                  e.updates / frames, e.update_ticks / ticks_per_us / frames,
+                  e.allocs, e.frees);
+  }
+  object_class_stats.clear();
 }
 
 void setup(void) {
@@ -337,12 +595,13 @@ void setup(void) {
   Serial.printf("             void*: %zu B\n", sizeof(void *));
 
   // allocate DMA buffers
-  dma_buf_1 = (uint16_t *)malloc(dma_buf_size);
-  dma_buf_2 = (uint16_t *)malloc(dma_buf_size);
-  if (!dma_buf_1 or !dma_buf_2) {
-    Serial.printf("!!! could not allocate DMA buffers");
-    while (true)
-      ;
+  for (unsigned i = 0; i < dma_bufs_count; i++) {
+    dma_bufs[i] = (uint16_t *)malloc(dma_buf_size);
+    if (!dma_bufs[i]) {
+      Serial.printf("!!! could not allocate DMA buffers");
+      while (true)
+        ;
+    }
   }
 
   engine_setup();
@@ -351,20 +610,38 @@ void setup(void) {
   Serial.printf("     free heap mem: %zu B\n", ESP.getFreeHeap());
   Serial.printf("largest free block: %zu B\n", ESP.getMaxAllocHeap());
   Serial.printf("------------------- in program memory --------------------\n");
+#ifdef USE_ASSET_PACK
+  Serial.printf("        asset pack: %u B\n", asset_pack.size_B());
+#else
   Serial.printf("     sprite images: %zu B\n", sizeof(sprite_imgs));
   Serial.printf("             tiles: %zu B\n", sizeof(tiles));
   Serial.printf("          tile map: %zu B\n", sizeof(tile_map));
+#endif
   Serial.printf("------------------- globals ------------------------------\n");
   Serial.printf("           sprites: %zu B\n", sizeof(sprites));
   Serial.printf("           objects: %zu B\n", sizeof(objects));
+  Serial.printf("        kinematics: %zu B\n", sizeof(kinematics));
+  Serial.printf("       object grid: %zu B\n", sizeof(object_grid));
+  Serial.printf("       broad phase: %zu B\n", sizeof(collision_broad_phase));
+  Serial.printf("       sprite bins: %zu B\n", sizeof(sprite_bins));
+  Serial.printf(" sprite collisions: %zu B\n", sizeof(sprite_collisions));
+  Serial.printf("        dirty rows: %zu B\n", sizeof(dirty_rows));
+  Serial.printf("        tile remap: %zu B\n", sizeof(tile_remap));
+  Serial.printf("  tile map overlay: %zu B\n", sizeof(tile_map_overlay));
+  Serial.printf("   tile map stream: %zu B\n", sizeof(tile_map_stream));
+  Serial.printf("          profiler: %zu B\n", sizeof(profiler));
   Serial.printf("------------------- on heap ------------------------------\n");
   Serial.printf("      sprites data: %zu B\n", sprites.allocated_data_size_B());
   Serial.printf("      objects data: %zu B\n", objects.allocated_data_size_B());
   Serial.printf("     collision map: %zu B\n", collision_map_size);
-  Serial.printf("   DMA buf 1 and 2: %zu B\n", 2 * dma_buf_size);
+  Serial.printf("        tile cache: %zu B (%u tiles)\n",
+                tile_cache.allocated_data_size_B(), tile_cache.count());
+  Serial.printf("       DMA buffers: %zu B (%u)\n",
+                dma_bufs_count * dma_buf_size, dma_bufs_count);
   Serial.printf("------------------- object sizes -------------------------\n");
   Serial.printf("            sprite: %zu B\n", sizeof(sprite));
   Serial.printf("            object: %zu B\n", sizeof(object));
+  Serial.printf("         sprite_ix: %zu B\n", sizeof(sprite_ix));
   Serial.printf("              tile: %zu B\n", sizeof(tile));
   Serial.printf("----------------------------------------------------------\n");
 
@@ -390,6 +667,30 @@ void setup(void) {
   display.init();
   display.setRotation(display_orientation);
   display.initDMA(true);
+  if (render_hw_vscroll) {
+    display_init_vscroll();
+  }
+
+  // start render task on core 0, 'loop()' runs on core 1
+  if (engine_pipelined) {
+    if (xTaskCreatePinnedToCore(render_task, "render", 4096, nullptr, 1,
+                                &render_task_handle, 0) != pdPASS) {
+      Serial.printf("!!! could not create render task");
+      while (true)
+        ;
+    }
+  }
+
+  // start band worker task on core 0
+  if (render_parallel_bands) {
+    if (xTaskCreatePinnedToCore(render_worker_task, "render worker", 4096,
+                                nullptr, 1, &render_worker_handle,
+                                0) != pdPASS) {
+      Serial.printf("!!! could not create render worker task");
+      while (true)
+        ;
+    }
+  }
 
 #ifdef USE_WIFI
   WiFi.begin(secret_wifi_network, secret_wifi_password);
@@ -420,6 +721,31 @@ void loop() {
     Serial.printf("t=%lu  fps=%u  ldr=%u  objs=%u  sprs=%u\n", clk.ms, clk.fps,
                   analogRead(cyd_ldr_pin), objects.allocated_list_len(),
                   sprites.allocated_list_len());
+    if (render_bench) {
+      for (unsigned w = 0; w < render_workers; w++) {
+        const unsigned n = render_bench_stats.bands[w];
+        Serial.printf("  worker %u: bands=%u  raster=%lu us/band\n", w, n,
+                      n ? render_bench_stats.raster_us[w] / n : 0);
+      }
+      const unsigned n = render_bench_stats.dma_bands;
+      Serial.printf("  display: bands=%u  dma=%lu us/band\n", n,
+                    n ? render_bench_stats.dma_us / n : 0);
+      render_bench_stats = {};
+    }
+    if (profiler_enabled) {
+      profiler_print();
+    }
+    if (engine_class_stats) {
+      object_class_stats_print();
+    }
+  }
+
+  if (profiler_enabled and Serial.available() and Serial.read() == 'p') {
+    profiler.dump(
+        [](const void *data, const size_t size) {
+          Serial.write((const uint8_t *)data, size);
+        },
+        ESP.getCpuFreqMHz());
   }
 
   if (touch_screen.tirqTouched() and touch_screen.touched()) {
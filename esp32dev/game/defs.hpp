@@ -6,8 +6,9 @@
 static constexpr uint8_t display_orientation = 0;
 
 // number of sprite images
-// defined in 'resources/sprite_imgs.hpp'
-static constexpr unsigned sprite_imgs_count = 256;
+// defined in 'resources/sprite_imgs.hpp' where identical images are emitted
+// once
+static constexpr unsigned sprite_imgs_count = 12;
 
 // type used to address instance in 'sprite_imgs' array
 using sprite_imgs_ix = uint8_t;
@@ -19,19 +20,117 @@ static constexpr unsigned tile_count = 256;
 // type used to index in the tiles images
 using tile_ix = uint8_t;
 
+// load palettes, sprites, tiles and tile map from the asset pack written to
+// the data partition instead of compiling in 'resources/*'
+// see 'utils/png-to-resources/README.md'
+// #define USE_ASSET_PACK
+
 // example configuration of more sprites and tiles
 // static constexpr unsigned sprite_imgs_count = 512;
 // using sprite_imgs_ix = uint16_t;
 // static constexpr unsigned tile_count = 512;
 // using tile_ix = uint16_t;
 
+// number of tile animations
+// defined in 'resources/tile_anims.hpp', 0 to disable
+static constexpr unsigned tile_anims_count = 0;
+
+// maximum number of frames in a tile animation
+static constexpr unsigned tile_anim_frames_max = 4;
+
+// type used to index sprites in the collision map where the maximum value is
+// reserved for 'no sprite'
+using sprite_ix = uint8_t;
+
+// number of sprites
+// note. less than or equal to maximum value of 'sprite_ix'
+static constexpr unsigned sprites_count = 255;
+
+// number of objects
+// note. objects and the extra sprites of the classes in 'object_class_sprites'
+//       at capacity must fit in 'sprites_count', e.g. 4 'hero' with 2 extra
+//       sprites each
+static constexpr unsigned objects_count = 247;
+
+// example configuration of more sprites and objects
+// note. collision map with 16-bit 'sprite_ix' requires 'collision_map_band'
+// using sprite_ix = uint16_t;
+// static constexpr unsigned sprites_count = 1024;
+// static constexpr unsigned objects_count = 1016;
+
+// render sprites using the opaque spans of the rows of the sprite images
+// defined in 'resources/sprite_imgs_spans*.hpp'
+static constexpr bool render_sprite_spans = true;
+
+// render full tiles with the word-wide kernel 'palette_expand_16' instead of
+// the per-byte loop
+// note. slower than the per-byte loop on the host at -Os, enable only if
+//       'render_bench' shows a gain on the device
+static constexpr bool render_tile_kernels = false;
+
+// number of most used tiles in the tile map that are kept as rgb 565 pixels in
+// heap, each using 512 B, for faster rendering. 0 to disable
+static constexpr unsigned tile_cache_size = 8;
+
 // tile map dimension
 // defined in 'resources/tile_map.hpp'
 static constexpr unsigned tile_map_width = 15;
 static constexpr unsigned tile_map_height = 320;
 
-// size that fits any instance of game object
-static constexpr unsigned object_instance_max_size_B = 256;
+// number of rows of tiles in the tile map that can be modified at run time
+// using 'tile_map_overlay.set(...)', a row is copied from flash to ram at first
+// write, each row using 'tile_map_width' * sizeof(tile_ix) B. 0 to disable
+static constexpr unsigned tile_map_ram_rows = 0;
+
+// number of rows of tiles in a ring decompressed, as the tile map scrolls,
+// from 'resources/tile_map_runs.hpp' instead of reading the tile map in flash,
+// at least the rows on screen plus 1, e.g. 24. 0 to disable
+static constexpr unsigned tile_map_stream_rows = 0;
+
+// collision map is one tile height of scanlines, re-used for every row of tiles
+// while rendering, instead of the whole screen
+static constexpr bool collision_map_band = true;
+
+// render only the rows of tiles on screen that changed due to sprites when the
+// tile map did not move since previous frame
+// note. collisions are detected only on rendered rows thus sprites overlapping
+//       without moving collide only once
+static constexpr bool render_dirty_rows = false;
+
+// when tile map moves only vertically, scroll the display memory using the
+// vertical scrolling of the display and render the newly exposed rows and the
+// rows of sprites
+// note. requires 'render_dirty_rows' and portrait orientation
+static constexpr bool render_hw_vscroll = false;
+
+// render a frame on the other core, while the objects are updated for the next
+// frame, from a copy of the render state of the sprites
+// note. collisions detected while rendering are applied one frame later
+static constexpr bool engine_pipelined = false;
+
+// rasterize alternating rows of tiles on both cores into a ring of DMA buffers
+// pushed to the display in order
+// note. requires 'collision_map_band' and not 'engine_pipelined'
+static constexpr bool render_parallel_bands = false;
+
+// simulate the game in fixed steps of milliseconds, 0 or more per frame, and
+// render sprites and tile map interpolated between the two last steps.
+// 0 to disable
+// note. 'main_on_frame_completed()' is called after every step
+static constexpr unsigned engine_fixed_dt_ms = 0;
+
+// store position, velocity and acceleration of game objects in a structure of
+// arrays integrated in one pass before the objects are updated
+// note. an object that dies in 'update()' has moved in that step
+static constexpr bool engine_kinematics_soa = false;
+
+// update objects grouped by class calling 'update()' without virtual dispatch
+// note. order of updates is by class instead of by allocation
+static constexpr bool engine_update_batched = false;
+
+// grid of object positions built every frame for queries of objects in an
+// area using 'object_grid'
+static constexpr bool engine_object_grid = false;
 
 // enumeration of game object classes
 // defined in 'objects/*'
@@ -46,6 +145,44 @@ enum object_class : uint8_t {
   upgrade_picked_cls
 };
 
+// number of object classes
+static constexpr unsigned object_class_count = upgrade_picked_cls + 1;
+
+// names of object classes used when printing statistics
+static constexpr const char *object_class_names[object_class_count]{
+    "hero",  "bullet", "dummy",   "fragment",
+    "ship1", "ship2",  "upgrade", "upgrade_picked"};
+
+// maximum number of concurrent objects of each class, pools sized to the
+// type of the class are allocated at 'engine_setup()'
+// note. total number of objects is limited to 'objects_count' in 'engine.hpp'
+static constexpr unsigned object_class_capacity[object_class_count]{
+    4,   // hero
+    64,  // bullet
+    1,   // dummy
+    128, // fragment
+    128, // ship1
+    16,  // ship2
+    16,  // upgrade
+    16,  // upgrade_picked
+};
+
+// number of sprites allocated by an object of each class
+static constexpr unsigned object_class_sprites[object_class_count]{
+    3, // hero
+    1, // bullet
+    1, // dummy
+    1, // fragment
+    1, // ship1
+    1, // ship2
+    1, // upgrade
+    1, // upgrade_picked
+};
+
+// record calls and time spent in 'update()', allocations and frees of objects
+// by class printed with frames per second
+static constexpr bool engine_class_stats = false;
+
 // define the size of collision bits
 using collision_bits = uint16_t;
 
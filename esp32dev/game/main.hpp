@@ -7,9 +7,20 @@
 #include "game_state.hpp"
 
 #include "objects/bullet.hpp"
+#include "objects/dummy.hpp"
+#include "objects/fragment.hpp"
 #include "objects/hero.hpp"
 #include "objects/ship1.hpp"
 #include "objects/ship2.hpp"
+#include "objects/upgrade.hpp"
+#include "objects/upgrade_picked.hpp"
+
+// types of the object classes in the order of 'enum object_class'
+using main_classes = object_classes<hero, bullet, dummy, fragment, ship1, ship2,
+                                    upgrade, upgrade_picked>;
+
+// callback at 'engine_setup()' allocating the pools of object classes
+static void main_init_objects() { objects.init(main_classes{}); }
 
 // callback at boot
 static void main_setup() {
@@ -20,14 +31,14 @@ static void main_setup() {
   // tile_map_y = 0;
   // tile_map_dy = 1;
 
-  hero *hro = new (objects.allocate_instance()) hero{};
-  hro->x = display_width / 2 - sprite_width / 2;
-  hro->y = 30;
+  hero *hro = new (objects.allocate_instance(hero_cls)) hero{};
+  hro->x() = display_width / 2 - sprite_width / 2;
+  hro->y() = 30;
 
-  // bullet *blt = new (objects.allocate_instance()) bullet{};
-  // blt->x = display_width / 2 - sprite_width / 2;
-  // blt->y = 300;
-  // blt->dy = -100;
+  // bullet *blt = new (objects.allocate_instance(bullet_cls)) bullet{};
+  // blt->x() = display_width / 2 - sprite_width / 2;
+  // blt->y() = 300;
+  // blt->dy() = -100;
 }
 
 unsigned long last_fire_ms = 0;
@@ -44,11 +55,12 @@ static void main_on_touch_screen(int16_t x, int16_t y, int16_t z) {
   if (clk.ms - last_fire_ms > 125) {
     // Serial.printf("touch  x=%u  y=%u\n", x, y);
     last_fire_ms = clk.ms;
-    if (objects.can_allocate()) {
-      bullet *blt = new (objects.allocate_instance()) bullet{};
-      blt->x = (x - touch_screen_min_x) * display_width / touch_screen_range_x;
-      blt->y = 300;
-      blt->dy = -100;
+    if (objects.can_allocate(bullet_cls)) {
+      bullet *blt = new (objects.allocate_instance(bullet_cls)) bullet{};
+      blt->x() =
+          (x - touch_screen_min_x) * display_width / touch_screen_range_x;
+      blt->y() = 300;
+      blt->dy() = -100;
     }
   }
 }
@@ -99,6 +111,9 @@ static constexpr unsigned wave_triggers_len =
 
 static unsigned wave_triggers_ix = 0;
 
+// callback updating objects when 'engine_update_batched'
+static void main_update_objects() { objects.update_batched(main_classes{}); }
+
 // callback after frame has been rendered, happens after 'update'
 static void main_on_frame_completed() {
   // update x position in pixels in the tile map
@@ -121,11 +136,11 @@ static void main_on_frame_completed() {
     wave_triggers_ix = 0;
   }
 
-  if (not game_state.hero_is_alive) {
-    hero *hro = new (objects.allocate_instance()) hero{};
-    hro->x = float(rand()) * display_width / RAND_MAX;
-    hro->y = 30;
-    hro->dx = float(rand()) * 64 / RAND_MAX;
+  if (not game_state.hero_is_alive and objects.can_allocate(hero_cls)) {
+    hero *hro = new (objects.allocate_instance(hero_cls)) hero{};
+    hro->x() = float(rand()) * display_width / RAND_MAX;
+    hro->y() = 30;
+    hro->dx() = float(rand()) * 64 / RAND_MAX;
   }
 
   // trigger waves
@@ -142,10 +157,13 @@ void main_wave_1() {
   float x = 8;
   float y = -float(sprite_height);
   for (unsigned i = 0; i < 8; i++) {
-    ship1 *shp = new (objects.allocate_instance()) ship1{};
-    shp->x = x;
-    shp->y = y;
-    shp->dy = 50;
+    if (not objects.can_allocate(ship1_cls)) {
+      return;
+    }
+    ship1 *shp = new (objects.allocate_instance(ship1_cls)) ship1{};
+    shp->x() = x;
+    shp->y() = y;
+    shp->dy() = 50;
     x += 32;
     y -= 8;
   }
@@ -155,10 +173,13 @@ void main_wave_2() {
   float x = 8;
   float y = -float(sprite_height);
   for (unsigned i = 0; i < 8; i++) {
-    ship1 *shp = new (objects.allocate_instance()) ship1{};
-    shp->x = x;
-    shp->y = y;
-    shp->dy = 50;
+    if (not objects.can_allocate(ship1_cls)) {
+      return;
+    }
+    ship1 *shp = new (objects.allocate_instance(ship1_cls)) ship1{};
+    shp->x() = x;
+    shp->y() = y;
+    shp->dy() = 50;
     x += 32;
   }
 }
@@ -168,32 +189,35 @@ void main_wave_3() {
   for (unsigned j = 0; j < 8; j++, y -= 24) {
     float x = 8;
     for (unsigned i = 0; i < 8; i++, x += 32) {
-      ship1 *shp = new (objects.allocate_instance()) ship1{};
-      shp->x = x;
-      shp->y = y;
-      shp->dy = 50;
+      if (not objects.can_allocate(ship1_cls)) {
+        return;
+      }
+      ship1 *shp = new (objects.allocate_instance(ship1_cls)) ship1{};
+      shp->x() = x;
+      shp->y() = y;
+      shp->dy() = 50;
     }
   }
 }
 
 void main_wave_4() {
-  {
-    ship2 *shp = new (objects.allocate_instance()) ship2{};
-    shp->x = -float(sprite_width);
-    shp->y = -float(sprite_height);
-    shp->dy = 25;
-    shp->dx = 12;
-    shp->ddy = 20;
-    shp->ddx = 10;
+  if (objects.can_allocate(ship2_cls)) {
+    ship2 *shp = new (objects.allocate_instance(ship2_cls)) ship2{};
+    shp->x() = -float(sprite_width);
+    shp->y() = -float(sprite_height);
+    shp->dy() = 25;
+    shp->dx() = 12;
+    shp->ddy() = 20;
+    shp->ddx() = 10;
   }
-  {
-    ship2 *shp = new (objects.allocate_instance()) ship2{};
-    shp->x = display_width;
-    shp->y = -float(sprite_height);
-    shp->dy = 25;
-    shp->dx = -12;
-    shp->ddy = 20;
-    shp->ddx = -10;
+  if (objects.can_allocate(ship2_cls)) {
+    ship2 *shp = new (objects.allocate_instance(ship2_cls)) ship2{};
+    shp->x() = display_width;
+    shp->y() = -float(sprite_height);
+    shp->dy() = 25;
+    shp->dx() = -12;
+    shp->ddy() = 20;
+    shp->ddx() = -10;
   }
 }
 
@@ -202,10 +226,10 @@ void main_wave_4() {
 //   for (unsigned j = 0; j < 12; j++, y -= 10) {
 //     float x = 8;
 //     for (unsigned i = 0; i < 20; i++, x += 10) {
-//       ship1 *shp = new (objects.allocate_instance()) ship1{};
-//       shp->x = x;
-//       shp->y = y;
-//       shp->dy = 30;
+//       ship1 *shp = new (objects.allocate_instance(ship1_cls)) ship1{};
+//       shp->x() = x;
+//       shp->y() = y;
+//       shp->dy() = 30;
 //     }
 //   }
 // }
\ No newline at end of file
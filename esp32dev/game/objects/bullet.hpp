@@ -21,17 +21,20 @@ public:
     if (game_object::update()) {
       return true;
     }
-    if (x <= -float(sprite_width) or x >= display_width or
-        y <= -float(sprite_height) or y >= display_height) {
+    if (x() <= -float(sprite_width) or x() >= display_width or
+        y() <= -float(sprite_height) or y() >= display_height) {
       return true;
     }
     return false;
   }
 
   void on_death_by_collision() override {
-    fragment *frg = new (objects.allocate_instance()) fragment{};
+    if (not objects.can_allocate(fragment_cls)) {
+      return;
+    }
+    fragment *frg = new (objects.allocate_instance(fragment_cls)) fragment{};
     frg->die_at_ms = clk.ms + 250;
-    frg->x = x;
-    frg->y = y;
+    frg->x() = x();
+    frg->y() = y();
   }
 };
@@ -11,7 +11,7 @@ public:
     if (game_object::update()) {
       return true;
     }
-    if (x > display_width) {
+    if (x() > display_width) {
       return true;
     }
     return false;
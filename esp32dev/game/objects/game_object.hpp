@@ -1,32 +1,91 @@
 #pragma once
 #include "../../engine.hpp"
 
+#include <type_traits>
+
+// position, velocity and acceleration stored in the object
+class game_object_kinematics_fields : public object {
+  float ddx_ = 0;
+  float dx_ = 0;
+  float x_ = 0;
+  float ddy_ = 0;
+  float dy_ = 0;
+  float y_ = 0;
+  float prv_x_ = 0;
+  float prv_y_ = 0;
+
+public:
+  game_object_kinematics_fields(const object_class c) : object{c} {}
+
+  inline auto ddx() -> float & { return ddx_; }
+  inline auto dx() -> float & { return dx_; }
+  inline auto x() -> float & { return x_; }
+  inline auto ddy() -> float & { return ddy_; }
+  inline auto dy() -> float & { return dy_; }
+  inline auto y() -> float & { return y_; }
+
+  // position at previous simulation step used to interpolate the position of
+  // the sprite when 'engine_fixed_dt_ms'
+  inline auto prv_x() -> float & { return prv_x_; }
+  inline auto prv_y() -> float & { return prv_y_; }
+};
+
+// position, velocity and acceleration in a lane of 'kinematics' when
+// 'engine_kinematics_soa'
+// note. same accessors as 'game_object_kinematics_fields' thus game code is
+//       the same in both cases
+// note. the lane index is updated by 'kinematics' when lanes are compacted
+class game_object_kinematics_lane : public object {
+  object_ix lane_;
+
+public:
+  game_object_kinematics_lane(const object_class c) : object{c} {
+    kinematics.allocate(lane_);
+  }
+
+  ~game_object_kinematics_lane() override { kinematics.free(lane_); }
+
+  inline auto ddx() -> float & { return kinematics.ddx[lane_]; }
+  inline auto dx() -> float & { return kinematics.dx[lane_]; }
+  inline auto x() -> float & { return kinematics.x[lane_]; }
+  inline auto ddy() -> float & { return kinematics.ddy[lane_]; }
+  inline auto dy() -> float & { return kinematics.dy[lane_]; }
+  inline auto y() -> float & { return kinematics.y[lane_]; }
+  inline auto prv_x() -> float & { return kinematics.prv_x[lane_]; }
+  inline auto prv_y() -> float & { return kinematics.prv_y[lane_]; }
+};
+
+using game_object_kinematics =
+    std::conditional<engine_kinematics_soa, game_object_kinematics_lane,
+                     game_object_kinematics_fields>::type;
+
 // implements common behavior of all game objects
-class game_object : public object {
+class game_object : public game_object_kinematics {
 public:
   sprite *spr = nullptr;
 
-  float ddx = 0;
-  float dx = 0;
-  float x = 0;
-  float ddy = 0;
-  float dy = 0;
-  float y = 0;
+  // true after first 'update()'
+  bool updated = false;
+
+  // index of entry in 'object_grid' when 'engine_object_grid'
+  object_ix grid_ix = 0;
 
   uint16_t health = 0;
 
   // damage inflicted on other object at collision
   uint16_t damage = 0;
 
-  // run time information about the class of this object
-  object_class cls;
-
-  game_object(object_class c) : cls{c} {}
+  game_object(const object_class c) : game_object_kinematics{c} {}
   // note. after constructor 'spr' must be in valid state.
 
   ~game_object() override {
-    // turn off sprite
+    if (engine_object_grid) {
+      object_grid.remove(grid_ix, this);
+    }
+    // turn off sprite and clear transforms for next user of the sprite
     spr->img = nullptr;
+    spr->palette = nullptr;
+    spr->flip = sprite_flip_none;
     sprites.free_instance(spr);
   }
 
@@ -41,18 +100,37 @@ public:
       col_with = nullptr;
     }
 
-    dx += ddx * clk.dt;
-    x += dx * clk.dt;
-    dy += ddy * clk.dt;
-    y += dy * clk.dt;
+    updated = true;
+
+    if (engine_kinematics_soa) {
+      // integrated by 'kinematics.update()'
+      return false;
+    }
+
+    prv_x() = x();
+    prv_y() = y();
+
+    dx() += ddx() * clk.dt;
+    x() += dx() * clk.dt;
+    dy() += ddy() * clk.dt;
+    y() += dy() * clk.dt;
 
     return false;
   }
 
   // called before rendering the sprites
   void pre_render() override {
-    spr->scr_x = int16_t(x);
-    spr->scr_y = int16_t(y);
+    if (engine_object_grid) {
+      grid_ix = object_ix(object_grid.add(this, x(), y()));
+    }
+    if (engine_fixed_dt_ms and updated) {
+      // interpolate between the two last simulation steps
+      spr->scr_x = int16_t(prv_x() + (x() - prv_x()) * clk.alpha);
+      spr->scr_y = int16_t(prv_y() + (y() - prv_y()) * clk.alpha);
+      return;
+    }
+    spr->scr_x = int16_t(x());
+    spr->scr_y = int16_t(y());
   }
 
   // called from 'update' if object is in collision
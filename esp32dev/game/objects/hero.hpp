@@ -39,9 +39,13 @@ public:
   }
 
   ~hero() override {
-    // turn off sprites
+    // turn off sprites and clear transforms for next user of the sprites
     spr_left->img = nullptr;
+    spr_left->palette = nullptr;
+    spr_left->flip = sprite_flip_none;
     spr_right->img = nullptr;
+    spr_right->palette = nullptr;
+    spr_right->flip = sprite_flip_none;
     // free sprite instances
     sprites.free_instance(spr_left);
     sprites.free_instance(spr_right);
@@ -55,20 +59,21 @@ public:
       return true;
     }
 
-    if (x > display_width) {
-      dx = -dx;
-      x = display_width;
-    } else if (x < sprite_width_neg) {
-      dx = -dx;
-      x = sprite_width_neg;
+    if (x() > display_width) {
+      dx() = -dx();
+      x() = display_width;
+    } else if (x() < sprite_width_neg) {
+      dx() = -dx();
+      x() = sprite_width_neg;
     }
 
-    if (clk.ms - last_upgrade_deployed_ms > upgrade_deploy_interval_ms) {
-      upgrade *upg = new (objects.allocate_instance()) upgrade{};
-      upg->x = x;
-      upg->y = y;
-      upg->dy = 30;
-      upg->ddy = 20;
+    if (clk.ms - last_upgrade_deployed_ms > upgrade_deploy_interval_ms and
+        objects.can_allocate(upgrade_cls)) {
+      upgrade *upg = new (objects.allocate_instance(upgrade_cls)) upgrade{};
+      upg->x() = x();
+      upg->y() = y();
+      upg->dy() = 30;
+      upg->ddy() = 20;
       last_upgrade_deployed_ms = clk.ms;
     }
 
@@ -94,14 +99,17 @@ private:
 
   void create_fragments() {
     for (unsigned i = 0; i < frag_count; i++) {
-      fragment *frg = new (objects.allocate_instance()) fragment{};
+      if (not objects.can_allocate(fragment_cls)) {
+        return;
+      }
+      fragment *frg = new (objects.allocate_instance(fragment_cls)) fragment{};
       frg->die_at_ms = clk.ms + 500;
-      frg->x = x;
-      frg->y = y;
-      frg->dx = frag_speed * rand() / RAND_MAX - frag_speed / 2;
-      frg->dy = frag_speed * rand() / RAND_MAX - frag_speed / 2;
-      frg->ddx = frag_speed * rand() / RAND_MAX - frag_speed / 2;
-      frg->ddy = frag_speed * rand() / RAND_MAX - frag_speed / 2;
+      frg->x() = x();
+      frg->y() = y();
+      frg->dx() = frag_speed * rand() / RAND_MAX - frag_speed / 2;
+      frg->dy() = frag_speed * rand() / RAND_MAX - frag_speed / 2;
+      frg->ddx() = frag_speed * rand() / RAND_MAX - frag_speed / 2;
+      frg->ddy() = frag_speed * rand() / RAND_MAX - frag_speed / 2;
     }
   }
 };
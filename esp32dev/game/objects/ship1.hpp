@@ -20,7 +20,7 @@ public:
       return true;
     }
 
-    if (y > display_height) {
+    if (y() > display_height) {
       return true;
     }
 
@@ -28,7 +28,7 @@ public:
       return true;
     }
 
-    if (y > display_height) {
+    if (y() > display_height) {
       return true;
     }
 
@@ -49,11 +49,14 @@ public:
   }
 
   void on_death_by_collision() override {
-    upgrade *upg = new (objects.allocate_instance()) upgrade{};
-    upg->x = x;
-    upg->y = y;
-    upg->dy = 30;
-    upg->ddy = 20;
+    if (not objects.can_allocate(upgrade_cls)) {
+      return;
+    }
+    upgrade *upg = new (objects.allocate_instance(upgrade_cls)) upgrade{};
+    upg->x() = x();
+    upg->y() = y();
+    upg->dy() = 30;
+    upg->ddy() = 20;
   }
 };
 
@@ -21,7 +21,7 @@ public:
       return true;
     }
 
-    if (y > display_height) {
+    if (y() > display_height) {
       return true;
     }
 
@@ -29,10 +29,14 @@ public:
   }
 
   void on_death_by_collision() override {
-    upgrade_picked *up = new (objects.allocate_instance()) upgrade_picked{};
-    up->x = x;
-    up->y = y;
-    up->dx = 50;
-    up->ddx = -30;
+    if (not objects.can_allocate(upgrade_picked_cls)) {
+      return;
+    }
+    upgrade_picked *up =
+        new (objects.allocate_instance(upgrade_picked_cls)) upgrade_picked{};
+    up->x() = x();
+    up->y() = y();
+    up->dx() = 50;
+    up->ddx() = -30;
   }
 };
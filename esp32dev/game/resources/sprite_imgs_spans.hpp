@@ -0,0 +1,12 @@
+{1,14},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{1,14},
+{4,8},{3,10},{3,10},{3,10},{3,10},{3,10},{3,10},{3,10},{3,10},{4,8},
+{0,2},{14,2},{0,4},{12,4},{1,5},{10,5},{1,14},{2,12},{2,12},{3,10},{3,10},{3,10},{3,10},{2,12},{2,12},{1,14},{1,5},{10,5},{0,4},{12,4},{0,2},{14,2},
+{8,1},{7,2},{7,1},{7,2},{8,1},{7,2},{7,1},{7,2},{8,1},{7,2},{7,1},{7,2},{8,1},
+{4,1},{11,1},{3,1},{12,1},{3,2},{11,2},{4,1},{11,1},{3,2},{11,2},{3,1},{12,1},{3,2},{11,2},{4,1},{11,1},{3,2},{11,2},{3,1},{12,1},{3,2},{11,2},{4,1},{11,1},
+{2,12},{1,14},{0,16},{0,16},{0,16},{1,14},{2,12},{3,10},{5,6},{6,4},{7,2},{7,2},
+{5,6},{3,10},{2,12},{1,14},{1,14},{1,14},{0,16},{0,16},{0,16},{1,14},{4,8},{3,2},{11,2},{2,2},{12,2},{1,2},{13,2},
+{5,6},{3,10},{2,12},{1,14},{1,14},{1,14},{0,16},{0,16},{0,16},{1,14},{4,8},{4,2},{10,2},{5,2},{9,2},{6,4},
+{7,2},{6,1},{9,1},{5,1},{7,2},{10,1},{4,1},{6,1},{9,1},{11,1},{3,1},{5,1},{7,2},{10,1},{12,1},{2,1},{4,1},{6,4},{11,1},{13,1},{1,1},{3,1},{5,6},{12,1},{14,1},{0,1},{2,1},{4,8},{13,1},{15,1},{0,1},{2,1},{4,8},{13,1},{15,1},{1,1},{3,1},{5,6},{12,1},{14,1},{2,1},{4,1},{6,4},{11,1},{13,1},{3,1},{5,1},{7,2},{10,1},{12,1},{4,1},{6,1},{9,1},{11,1},{5,1},{7,2},{10,1},{6,1},{9,1},{7,2},
+{1,14},{0,7},{9,7},{0,6},{7,2},{10,6},{0,5},{6,1},{9,1},{11,5},{0,4},{5,1},{7,2},{10,1},{12,4},{0,3},{4,1},{6,4},{11,1},{13,3},{0,2},{3,1},{5,6},{12,1},{14,2},{0,1},{2,1},{4,8},{13,1},{15,1},{0,1},{2,1},{4,8},{13,1},{15,1},{0,2},{3,1},{5,6},{12,1},{14,2},{0,3},{4,1},{6,4},{11,1},{13,3},{0,4},{5,1},{7,2},{10,1},{12,4},{0,5},{6,1},{9,1},{11,5},{0,6},{7,2},{10,6},{0,7},{9,7},{1,14},
+
+{1,14},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{0,16},{1,14},
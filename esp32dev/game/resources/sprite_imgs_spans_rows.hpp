@@ -0,0 +1,13 @@
+0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,
+16,16,16,16,17,18,19,20,21,22,23,24,25,26,26,26,
+26,28,30,32,33,34,35,36,37,38,39,40,41,42,44,46,
+48,48,49,50,51,52,53,54,55,56,57,58,59,60,61,61,
+61,61,61,63,65,67,69,71,73,75,77,79,81,83,85,85,
+85,85,85,86,87,88,89,90,91,92,93,94,95,96,97,97,
+97,97,97,98,99,100,101,102,103,104,105,106,107,108,110,112,
+114,114,114,115,116,117,118,119,120,121,122,123,124,125,127,129,
+130,131,133,136,140,145,150,155,160,165,170,175,180,184,187,189,
+190,191,193,196,200,205,210,215,220,225,230,235,240,244,247,249,
+250,250,250,250,250,250,250,250,250,250,250,250,250,250,250,250,
+250,251,252,253,254,255,256,257,258,259,260,261,262,263,264,265,
+266
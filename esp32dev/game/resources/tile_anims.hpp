@@ -0,0 +1,5 @@
+// animations of tiles in the tile map, 'tile_anims_count' entries in
+// 'defs.hpp', hand written since tile images are not tagged
+// format: {tile in map, milliseconds per frame, frames count, {frames}},
+// example of tile 5 cycling images 5, 6, 7 at 4 frames per second:
+// {5, 250, 3, {5, 6, 7}},
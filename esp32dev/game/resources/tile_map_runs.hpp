@@ -0,0 +1,2 @@
+// clang-format off
+{15,2},{15,1},
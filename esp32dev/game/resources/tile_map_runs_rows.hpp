@@ -0,0 +1,21 @@
+// clang-format off
+0,1,1,1,1,1,1,1,1,1,0,1,1,1,1,1,
+1,1,1,1,0,1,1,1,1,1,1,1,1,1,0,1,
+1,1,1,1,1,1,1,1,0,1,1,1,1,1,1,1,
+1,1,0,1,1,1,1,1,1,1,1,1,0,1,1,1,
+1,1,1,1,1,1,0,1,1,1,1,1,1,1,1,1,
+0,1,1,1,1,1,1,1,1,1,0,1,1,1,1,1,
+1,1,1,1,0,1,1,1,1,1,1,1,1,1,0,1,
+1,1,1,1,1,1,1,1,0,1,1,1,1,1,1,1,
+1,1,0,1,1,1,1,1,1,1,1,1,0,1,1,1,
+1,1,1,1,1,1,0,1,1,1,1,1,1,1,1,1,
+0,1,1,1,1,1,1,1,1,1,0,1,1,1,1,1,
+1,1,1,1,0,1,1,1,1,1,1,1,1,1,0,1,
+1,1,1,1,1,1,1,1,0,1,1,1,1,1,1,1,
+1,1,0,1,1,1,1,1,1,1,1,1,0,1,1,1,
+1,1,1,1,1,1,0,1,1,1,1,1,1,1,1,1,
+0,1,1,1,1,1,1,1,1,1,0,1,1,1,1,1,
+1,1,1,1,0,1,1,1,1,1,1,1,1,1,0,1,
+1,1,1,1,1,1,1,1,0,1,1,1,1,1,1,1,
+1,1,0,1,1,1,1,1,1,1,1,1,0,1,1,1,
+1,1,1,1,1,1,0,1,1,1,1,1,1,1,1,1,
@@ -0,0 +1,154 @@
+#pragma once
+// frame profiler recording the time spent in the phases of 'engine_loop()' and
+// rendering the bands in a ring buffer of frames
+// note. platform independent, time is in ticks of the platform e.g. cpu cycles
+// note. 'profiler_enabled' is defined by the platform before including
+
+#include "engine.hpp"
+
+#include <algorithm>
+
+// names of phases in 'enum engine_phase'
+static constexpr const char *profiler_phase_names[engine_phases_count]{
+    "update", "pre_render", "collisions", "render", "game", "stream", "other"};
+
+class profiler {
+public:
+  // number of frames in ring buffer, 1 when not used
+  static constexpr unsigned frames_count = profiler_enabled ? 128 : 1;
+
+  // ticks spent in a frame
+  class frame {
+  public:
+    // in each phase of 'engine_loop()', 'phase_done' is time outside
+    uint32_t phase[engine_phases_count];
+    // rasterizing bands by each render worker
+    uint32_t raster[render_workers];
+    // pushing bands to the display including waiting for previous transfer
+    uint32_t dma_wait;
+    // number of bands rendered by each render worker
+    uint16_t bands[render_workers];
+  };
+
+  // statistics of a measurement over the frames in ring buffer
+  class stats {
+  public:
+    uint32_t min;
+    uint32_t avg;
+    uint32_t p99;
+  };
+
+private:
+  frame frames_[frames_count]{};
+  // index of frame being recorded
+  unsigned frame_ix_ = 0;
+  // number of recorded frames
+  unsigned frames_len_ = 0;
+  engine_phase phase_ = phase_done;
+  uint32_t phase_start_ = 0;
+  // index of frame the renderer records to, captured at 'on_render_start()'
+  unsigned render_frame_ix_ = 0;
+
+public:
+  // called at start of every phase with current ticks
+  // note. a frame is complete when 'phase_update' follows 'phase_done'
+  void on_phase(const engine_phase phase, const uint32_t now) {
+    frames_[frame_ix_].phase[phase_] += now - phase_start_;
+    if (phase_ == phase_done and phase == phase_update) {
+      frame_ix_ = (frame_ix_ + 1) % frames_count;
+      if (frames_len_ < frames_count) {
+        frames_len_++;
+      }
+      frames_[frame_ix_] = {};
+    }
+    phase_ = phase;
+    phase_start_ = now;
+  }
+
+  // called on the core running 'engine_loop()' when a frame is handed to the
+  // renderer, before 'on_raster' and 'on_push' of the frame
+  // note. when 'engine_pipelined' the render task records into this frame
+  //       while 'on_phase' moves to the next frame
+  inline void on_render_start() { render_frame_ix_ = frame_ix_; }
+
+  // called by render 'worker' after rasterizing a band
+  // note. each worker writes only its own counters
+  inline void on_raster(const unsigned worker, const uint32_t ticks) {
+    frame &f = frames_[render_frame_ix_];
+    f.raster[worker] += ticks;
+    f.bands[worker]++;
+  }
+
+  // called after pushing a band to the display
+  inline void on_push(const uint32_t ticks) {
+    frames_[render_frame_ix_].dma_wait += ticks;
+  }
+
+  // number of recorded frames
+  inline auto frames_len() const -> unsigned { return frames_len_; }
+
+  // returns statistics of the value returned by 'get' for recorded frames
+  template <typename Get> auto stats_of(Get get) const -> stats {
+    uint32_t values[frames_count];
+    uint64_t sum = 0;
+    for (unsigned i = 0; i < frames_len_; i++) {
+      values[i] = get(recorded(i));
+      sum += values[i];
+    }
+    if (frames_len_ == 0) {
+      return {0, 0, 0};
+    }
+    std::sort(values, values + frames_len_);
+    return {values[0], uint32_t(sum / frames_len_),
+            values[frames_len_ * 99 / 100]};
+  }
+
+  // returns recorded frame 'i' where 0 is the oldest
+  inline auto recorded(const unsigned i) const -> const frame & {
+    return frames_[(frame_ix_ + frames_count - frames_len_ + i) % frames_count];
+  }
+
+  // writes the recorded frames in binary using 'write(data, size)'
+  // format, little endian:
+  //   "PRF2", u32 ticks per microsecond, u8 phases count, u8 workers count,
+  //   u16 frames count, phase names as zero terminated strings, frames from
+  //   oldest: u32 ticks of each phase, u32 raster ticks of each worker, u32
+  //   dma wait ticks, u16 bands of each worker
+  template <typename Write>
+  void dump(Write write, const uint32_t ticks_per_us) const {
+    write("PRF2", 4);
+    write_u32(write, ticks_per_us);
+    const uint8_t counts[]{uint8_t(engine_phases_count),
+                           uint8_t(render_workers)};
+    write(counts, sizeof(counts));
+    write_u16(write, uint16_t(frames_len_));
+    for (const char *name : profiler_phase_names) {
+      write(name, strlen(name) + 1);
+    }
+    for (unsigned i = 0; i < frames_len_; i++) {
+      const frame &f = recorded(i);
+      for (const uint32_t ticks : f.phase) {
+        write_u32(write, ticks);
+      }
+      for (const uint32_t ticks : f.raster) {
+        write_u32(write, ticks);
+      }
+      write_u32(write, f.dma_wait);
+      for (const uint16_t bands : f.bands) {
+        write_u16(write, bands);
+      }
+    }
+  }
+
+private:
+  template <typename Write> static void write_u32(Write write, uint32_t v) {
+    const uint8_t b[]{uint8_t(v), uint8_t(v >> 8), uint8_t(v >> 16),
+                      uint8_t(v >> 24)};
+    write(b, sizeof(b));
+  }
+
+  template <typename Write> static void write_u16(Write write, uint16_t v) {
+    const uint8_t b[]{uint8_t(v), uint8_t(v >> 8)};
+    write(b, sizeof(b));
+  }
+} static profiler{};
@@ -0,0 +1,87 @@
+#pragma once
+// platform independent rendering kernels, placed in internal ram on ESP32
+// note. 'palette_expand_16' is used only when 'render_tile_kernels', it is not
+//       measured on the device and on the host built with -Os it is slower
+//       than the per-byte loop, see 'utils/render-kernels-bench/README.md'
+// note. no Xtensa specific variant, the ESP32 (LX6) has no SIMD or gather
+//       instructions for the palette lookups
+// note. included by 'utils/render-kernels-bench' for host benchmarking
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef ESP32
+// kernels placed in internal ram to avoid stalls on flash cache misses
+#include <esp_attr.h>
+#define RENDER_KERNEL IRAM_ATTR
+#else
+#define RENDER_KERNEL
+#endif
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "word-wide kernels assume little endian byte order");
+
+// expands 'n' 8-bit palette indexes from 'src' to rgb 565 pixels in 'dst'
+// note. used for partial tiles where 'src' and 'dst' may be unaligned
+static RENDER_KERNEL void palette_expand(uint16_t *dst, const uint8_t *src,
+                                         const uint16_t *palette,
+                                         const unsigned n) {
+  for (unsigned i = 0; i < n; i++) {
+    *dst++ = palette[*src++];
+  }
+}
+
+// expands 'n' 8-bit palette indexes read backwards from 'src' to rgb 565
+// pixels in 'dst'
+// note. used for sprites mirrored horizontally
+static RENDER_KERNEL void palette_expand_reverse(uint16_t *dst,
+                                                 const uint8_t *src,
+                                                 const uint16_t *palette,
+                                                 const unsigned n) {
+  for (unsigned i = 0; i < n; i++) {
+    *dst++ = palette[*src--];
+  }
+}
+
+// expands 4 palette indexes packed in 'w' to 2 pixel pairs in 4-byte aligned
+// 'dst'
+static inline void palette_expand_4_aligned(uint32_t *dst, const uint32_t w,
+                                            const uint16_t *palette) {
+  dst[0] = uint32_t(palette[w & 0xff]) |
+           (uint32_t(palette[(w >> 8) & 0xff]) << 16);
+  dst[1] = uint32_t(palette[(w >> 16) & 0xff]) |
+           (uint32_t(palette[w >> 24]) << 16);
+}
+
+// expands 4 palette indexes packed in 'w' to 4 pixels in 2-byte aligned 'dst'
+static inline void palette_expand_4(uint16_t *dst, const uint32_t w,
+                                    const uint16_t *palette) {
+  dst[0] = palette[w & 0xff];
+  dst[1] = palette[(w >> 8) & 0xff];
+  dst[2] = palette[(w >> 16) & 0xff];
+  dst[3] = palette[w >> 24];
+}
+
+// expands a full tile row of 16 palette indexes from 4-byte aligned 'src'
+// using 32-bit loads and, if 'dst' is 4-byte aligned, 32-bit stores
+// note. unrolled since build is optimized for size
+static RENDER_KERNEL void palette_expand_16(uint16_t *dst, const uint8_t *src,
+                                            const uint16_t *palette) {
+  uint32_t w[4];
+  // note. 'memcpy' avoids aliasing issues and compiles to 32-bit loads
+  memcpy(w, __builtin_assume_aligned(src, 4), sizeof(w));
+  if ((uintptr_t(dst) & 3) == 0) {
+    uint32_t d[8];
+    palette_expand_4_aligned(&d[0], w[0], palette);
+    palette_expand_4_aligned(&d[2], w[1], palette);
+    palette_expand_4_aligned(&d[4], w[2], palette);
+    palette_expand_4_aligned(&d[6], w[3], palette);
+    memcpy(__builtin_assume_aligned(dst, 4), d, sizeof(d));
+  } else {
+    // 'dst' is odd pixel aligned when tile map x is odd
+    palette_expand_4(&dst[0], w[0], palette);
+    palette_expand_4(&dst[4], w[1], palette);
+    palette_expand_4(&dst[8], w[2], palette);
+    palette_expand_4(&dst[12], w[3], palette);
+  }
+}
@@ -0,0 +1,215 @@
+#pragma once
+// platform independent rendering of tiles and sprites to scanlines and of
+// sprites to the collision map
+// note. included by 'esp32dev.ino' and host build 'utils/host-bench'
+
+#include "engine.hpp"
+
+// kernels used when rendering
+#include "render_kernels.hpp"
+
+// copy of 'palette_tiles' in internal ram that is faster to access than flash
+static uint16_t palette_tiles_ram[256];
+
+static void render_init() {
+  memcpy(palette_tiles_ram, palette_tiles, sizeof(palette_tiles_ram));
+}
+
+static_assert(tile_width == 16, "kernel 'palette_expand_16' expects tile "
+                                "width 16");
+
+// called when sprite 'i' writes a pixel while rendered by 'worker'
+// records collision with the sprite already at 'collision_pixel', if any, then
+// writes 'i' to 'collision_pixel'
+static inline void render_collision(sprite_ix *collision_pixel,
+                                    const sprite_ix i, const unsigned worker) {
+  if (*collision_pixel != sprite_ix_reserved) {
+    sprite_collisions.on_overlap(worker, i, *collision_pixel);
+  }
+  // set pixel collision value to sprite index
+  *collision_pixel = i;
+}
+
+// renders row 'img_row' of the image of sprite 'spr' to the scanline and, if
+// the sprite may collide, to the collision map
+// note. instantiated for mirrored and not mirrored horizontally keeping the
+//       loops without branches on the transform
+template <bool FlipH>
+static inline void render_sprite_row(uint16_t *scanline_ptr,
+                                     sprite_ix *collision_map_scanline_ptr,
+                                     const sprite_render_state *spr,
+                                     const unsigned img_row,
+                                     const unsigned worker) {
+  const sprite_ix i = spr->ix;
+  const bool may_collide = spr->may_collide;
+  const uint16_t *palette = spr->palette;
+  const uint8_t *spr_row_ptr = spr->img + img_row * sprite_width;
+  // image data of the pixel at screen 'x' and direction of next pixel
+  auto data_at = [spr, spr_row_ptr](const int x) -> const uint8_t * {
+    return FlipH ? spr_row_ptr + (int(sprite_width) - 1 - (x - spr->scr_x))
+                 : spr_row_ptr + (x - spr->scr_x);
+  };
+  constexpr int step = FlipH ? -1 : 1;
+  if (render_sprite_spans and spr->spans_row != sprite_render_state::no_spans) {
+    // render the opaque spans of the sprite row
+    const unsigned spans_row = spr->spans_row + img_row;
+    const sprite_img_span *span =
+        sprite_img_spans + sprite_img_spans_rows[spans_row];
+    const sprite_img_span *span_end =
+        sprite_img_spans + sprite_img_spans_rows[spans_row + 1];
+    for (; span < span_end; span++) {
+      // clip span to screen
+      int x = spr->scr_x + (FlipH ? int(sprite_width) - span->x - span->len
+                                  : span->x);
+      int x_end = x + span->len;
+      if (x < 0) {
+        x = 0;
+      }
+      if (x_end > int(display_width)) {
+        x_end = display_width;
+      }
+      if (x >= x_end) {
+        continue;
+      }
+      const uint8_t *spr_data_ptr = data_at(x);
+      uint16_t *scanline_dst_ptr = scanline_ptr + x;
+      if (not may_collide) {
+        if (FlipH) {
+          palette_expand_reverse(scanline_dst_ptr, spr_data_ptr, palette,
+                                 unsigned(x_end - x));
+        } else {
+          palette_expand(scanline_dst_ptr, spr_data_ptr, palette,
+                         unsigned(x_end - x));
+        }
+        continue;
+      }
+      sprite_ix *collision_pixel = collision_map_scanline_ptr + x;
+      for (; x < x_end; x++, spr_data_ptr += step) {
+        *scanline_dst_ptr++ = palette[*spr_data_ptr];
+        render_collision(collision_pixel++, i, worker);
+      }
+    }
+    return;
+  }
+  // clip sprite row to screen
+  int x = spr->scr_x;
+  int x_end = x + int(sprite_width);
+  if (x < 0) {
+    x = 0;
+  }
+  if (x_end > int(display_width)) {
+    x_end = display_width;
+  }
+  const uint8_t *spr_data_ptr = data_at(x);
+  uint16_t *scanline_dst_ptr = scanline_ptr + x;
+  sprite_ix *collision_pixel = collision_map_scanline_ptr + x;
+  // render scanline of sprite
+  for (; x < x_end;
+       x++, spr_data_ptr += step, collision_pixel++, scanline_dst_ptr++) {
+    // write pixel from sprite data or skip if 0
+    const uint8_t color_ix = *spr_data_ptr;
+    if (color_ix) {
+      *scanline_dst_ptr = palette[color_ix];
+      if (may_collide) {
+        render_collision(collision_pixel, i, worker);
+      }
+    }
+  }
+}
+
+// clang-format off
+// note. not formatted because compiler gets confused and issues invalid error
+static void render_scanline(
+    uint16_t *render_buf_ptr,
+    sprite_ix *collision_map_scanline_ptr,
+    const int16_t scanline_y,
+    const unsigned tile_x,
+    const unsigned tile_dx,
+    const unsigned tile_width_minus_dx,
+    const tile_ix *tiles_map_row_ptr,
+    const unsigned tile_sub_y,
+    const unsigned tile_sub_y_times_tile_width,
+    const unsigned worker
+) {
+  // clang-format on
+  // used later by sprite renderer to overwrite tiles pixels
+  uint16_t *scanline_ptr = render_buf_ptr;
+
+  // render first partial tile
+  // note. tiles in 'tile_cache' are copied, others expanded using palette
+  {
+    const tile_ix tile_index = tile_remap.tile_of(tiles_map_row_ptr[tile_x]);
+    const uint16_t *cached = tile_cache.pixels(tile_index);
+    if (cached) {
+      memcpy(render_buf_ptr, cached + tile_sub_y_times_tile_width + tile_dx,
+             tile_width_minus_dx * sizeof(uint16_t));
+    } else {
+      palette_expand(render_buf_ptr,
+                     tiles[tile_index].data + tile_sub_y_times_tile_width +
+                         tile_dx,
+                     palette_tiles_ram, tile_width_minus_dx);
+    }
+    render_buf_ptr += tile_width_minus_dx;
+  }
+  // render full tiles
+  const unsigned tx_max = tile_x + (display_width / tile_width);
+  for (unsigned tx = tile_x + 1; tx < tx_max; tx++) {
+    const tile_ix tile_index = tile_remap.tile_of(tiles_map_row_ptr[tx]);
+    const uint16_t *cached = tile_cache.pixels(tile_index);
+    if (cached) {
+      memcpy(render_buf_ptr, cached + tile_sub_y_times_tile_width,
+             tile_width * sizeof(uint16_t));
+    } else if (render_tile_kernels) {
+      palette_expand_16(render_buf_ptr,
+                        tiles[tile_index].data + tile_sub_y_times_tile_width,
+                        palette_tiles_ram);
+    } else {
+      palette_expand(render_buf_ptr,
+                     tiles[tile_index].data + tile_sub_y_times_tile_width,
+                     palette_tiles_ram, tile_width);
+    }
+    render_buf_ptr += tile_width;
+  }
+  if (tile_dx) {
+    // render last partial tile
+    const tile_ix tile_index = tile_remap.tile_of(tiles_map_row_ptr[tx_max]);
+    const uint16_t *cached = tile_cache.pixels(tile_index);
+    if (cached) {
+      memcpy(render_buf_ptr, cached + tile_sub_y_times_tile_width,
+             tile_dx * sizeof(uint16_t));
+    } else {
+      palette_expand(render_buf_ptr,
+                     tiles[tile_index].data + tile_sub_y_times_tile_width,
+                     palette_tiles_ram, tile_dx);
+    }
+  }
+
+  // render sprites that are in the band of the scanline
+  // note. bins contain only sprites with image and within the screen
+
+  unsigned len = 0;
+  const sprite_ix *bin_it = sprite_bins.bin(unsigned(scanline_y), len);
+  for (unsigned k = 0; k < len; k++, bin_it++) {
+    const sprite_render_state *spr = sprite_bins.state(*bin_it);
+    if (spr->scr_y > scanline_y or
+        spr->scr_y + int16_t(sprite_height) <= scanline_y) {
+      // sprite not within scanline
+      continue;
+    }
+    // sprites that cannot collide do not access the collision map
+    if (spr->may_collide) {
+      collision_map_dirty[worker] = true;
+    }
+    // row of the image, bottom up if flipped vertically
+    const unsigned spr_row = unsigned(scanline_y - spr->scr_y);
+    const unsigned img_row =
+        spr->flip & sprite_flip_v ? sprite_height - 1 - spr_row : spr_row;
+    if (spr->flip & sprite_flip_h) {
+      render_sprite_row<true>(scanline_ptr, collision_map_scanline_ptr, spr,
+                              img_row, worker);
+    } else {
+      render_sprite_row<false>(scanline_ptr, collision_map_scanline_ptr, spr,
+                               img_row, worker);
+    }
+  }
+}
@@ -0,0 +1,429 @@
+// headless host build of the engine and game with a software renderer
+//
+// replays a scenario for a number of frames at fixed 'clk.dt' and prints the
+// time per frame of the phases of 'engine_loop()' and a hash of the last frame
+//
+// usage: bench scenario [frames] [check]
+//   scenario: game, wave_1, wave_2, wave_3, wave_4
+//   check: compares queries of 'object_grid' with a scan of all objects every
+//          frame, requires 'engine_object_grid'
+//
+// usage: bench flip [sprites]
+//   renders sprites with random image, position, flip and palette one at a
+//   time and compares the frame with a reference drawn from the image
+
+#include "host.hpp"
+
+#include "../../game/main.hpp"
+
+#include "../../renderer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#ifdef USE_ASSET_PACK
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// the display
+static uint16_t framebuffer[display_width * display_height];
+
+// renders all rows of tiles, first and last may be partial, to 'framebuffer'
+static void render(const unsigned x, const unsigned y) {
+  const unsigned tile_x = x >> tile_width_shift;
+  const unsigned tile_dx = x & tile_width_and;
+  const unsigned tile_width_minus_dx = tile_width - tile_dx;
+  const unsigned tile_y = y >> tile_height_shift;
+  const unsigned tile_dy = y & tile_height_and;
+
+  unsigned tile_row = tile_y;
+  unsigned tile_sub_y = tile_dy;
+  unsigned frame_y = 0;
+  while (frame_y < display_height) {
+    unsigned band_height = tile_height - tile_sub_y;
+    if (frame_y + band_height > display_height) {
+      band_height = display_height - frame_y;
+    }
+    const tile_ix *tiles_map_row_ptr = tile_map_overlay.row(tile_row);
+    sprite_ix *collision_map_scanline_ptr = collision_map;
+    if (collision_map_band) {
+      collision_map_clear();
+    } else {
+      collision_map_scanline_ptr += frame_y * display_width;
+    }
+    uint16_t *render_buf_ptr = framebuffer + frame_y * display_width;
+    int16_t scanline_y = int16_t(frame_y);
+    for (unsigned sub_y = tile_sub_y,
+                  tile_sub_y_times_tile_width = tile_sub_y * tile_width;
+         sub_y < tile_sub_y + band_height;
+         sub_y++, tile_sub_y_times_tile_width += tile_width,
+                  render_buf_ptr += display_width,
+                  collision_map_scanline_ptr += display_width, scanline_y++) {
+
+      render_scanline(render_buf_ptr, collision_map_scanline_ptr, scanline_y,
+                      tile_x, tile_dx, tile_width_minus_dx, tiles_map_row_ptr,
+                      sub_y, tile_sub_y_times_tile_width, 0);
+    }
+    frame_y += band_height;
+    tile_sub_y = 0;
+    tile_row++;
+  }
+}
+
+// rendering is not done on another core on the host
+static void render_start(const unsigned x, const unsigned y) { render(x, y); }
+
+static void render_wait() {}
+
+using bench_clock = std::chrono::steady_clock;
+
+// ticks are nanoseconds on the host
+static auto engine_ticks() -> uint32_t {
+  return uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      bench_clock::now().time_since_epoch())
+                      .count());
+}
+
+#ifdef USE_ASSET_PACK
+// maps the file in environment variable 'ASSET_PACK' or 'assets.bin'
+static auto asset_pack_map(uint32_t &size) -> const uint8_t * {
+  const char *path = getenv("ASSET_PACK");
+  const int fd = open(path ? path : "assets.bin", O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  void *ptr = MAP_FAILED;
+  if (fstat(fd, &st) == 0) {
+    ptr = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    return nullptr;
+  }
+  size = uint32_t(st.st_size);
+  return (const uint8_t *)ptr;
+}
+#endif
+
+// time spent in each phase
+static uint64_t phase_ns[engine_phases_count]{};
+static engine_phase phase_current = phase_done;
+static bench_clock::time_point phase_start{};
+
+static void on_engine_phase(const engine_phase phase) {
+  const bench_clock::time_point now = bench_clock::now();
+  phase_ns[phase_current] += uint64_t(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - phase_start)
+          .count());
+  phase_current = phase;
+  phase_start = now;
+}
+
+// state of the pseudo-random generator of the check of 'object_grid'
+// note. separate from 'rand()' thus the game plays the same with and without
+//       the check
+static uint32_t check_seed = 1;
+
+// returns a pseudo-random number from 'lo' to 'hi'
+static auto check_rand(const float lo, const float hi) -> float {
+  check_seed = check_seed * 1664525u + 1013904223u;
+  return lo + (hi - lo) * float(check_seed >> 8) / float(1u << 24);
+}
+
+// objects found by a query sorted by address
+using check_found = std::vector<object *>;
+
+// returns true if 'found' and 'expected' are the same objects
+static auto check_same(check_found &found, check_found &expected) -> bool {
+  std::sort(found.begin(), found.end());
+  std::sort(expected.begin(), expected.end());
+  return found == expected;
+}
+
+// compares random rectangle and radius queries of 'object_grid', including
+// areas outside the screen, with a scan of the objects added to the grid at
+// the last 'pre_render()'
+// note. objects allocated after 'pre_render()', e.g. by
+//       'main_on_frame_completed()', are appended to the allocated list and
+//       are not in the grid
+// returns number of queries or 0 if a query differs
+static auto check_object_grid() -> unsigned {
+  static constexpr unsigned queries_count = 32;
+  static constexpr float margin = 64;
+  object **objs = objects.allocated_list();
+  const unsigned len = object_grid.entries_len();
+  check_found found;
+  check_found expected;
+  for (unsigned i = 0; i < queries_count; i++) {
+    const float x0 = check_rand(-margin, display_width + margin);
+    const float y0 = check_rand(-margin, display_height + margin);
+    const float x1 = x0 + check_rand(0, display_width / 2);
+    const float y1 = y0 + check_rand(0, display_height / 2);
+    found.clear();
+    expected.clear();
+    object_grid.query_rect(x0, y0, x1, y1,
+                           [&](object *obj) { found.push_back(obj); });
+    for (unsigned j = 0; j < len; j++) {
+      game_object *obj = static_cast<game_object *>(objs[j]);
+      if (obj->x() >= x0 and obj->x() <= x1 and obj->y() >= y0 and
+          obj->y() <= y1) {
+        expected.push_back(obj);
+      }
+    }
+    if (not check_same(found, expected)) {
+      fprintf(stderr,
+              "!!! query_rect(%g, %g, %g, %g) found %zu expected %zu\n",
+              double(x0), double(y0), double(x1), double(y1), found.size(),
+              expected.size());
+      return 0;
+    }
+
+    const float r = check_rand(0, display_width / 2);
+    found.clear();
+    expected.clear();
+    object_grid.query_radius(x0, y0, r,
+                             [&](object *obj) { found.push_back(obj); });
+    for (unsigned j = 0; j < len; j++) {
+      game_object *obj = static_cast<game_object *>(objs[j]);
+      const float dx = obj->x() - x0;
+      const float dy = obj->y() - y0;
+      if (dx * dx + dy * dy <= r * r) {
+        expected.push_back(obj);
+      }
+    }
+    if (not check_same(found, expected)) {
+      fprintf(stderr, "!!! query_radius(%g, %g, %g) found %zu expected %zu\n",
+              double(x0), double(y0), double(r), found.size(),
+              expected.size());
+      return 0;
+    }
+  }
+  return 2 * queries_count;
+}
+
+// renders the tile map and the on screen sprites to 'framebuffer' as
+// 'engine_loop()' does without updating the objects
+static void render_sprites() {
+  collision_broad_phase.update();
+  sprite_bins.build();
+  sprite_collisions.prepare();
+  if (not collision_map_band) {
+    collision_map_clear();
+  }
+  render(unsigned(tile_map_x), unsigned(tile_map_y));
+}
+
+// renders 'count' sprites with random image, position, flip and palette, on
+// the game as set up by 'main_setup()' with its sprites hidden, and compares
+// the frames with a reference drawn from the image
+// note. images are either in 'sprite_imgs', rendered using spans if
+//       'render_sprite_spans', or a copy rendered pixel by pixel
+// returns true if all frames are the same as the reference
+static auto check_sprite_transforms(const unsigned count) -> bool {
+  static constexpr unsigned img_size = sprite_width * sprite_height;
+  static uint8_t img_copy[img_size];
+  static uint16_t palette[256];
+  static uint16_t background[display_width * display_height];
+  static object obj{dummy_cls};
+
+  // hide the sprites of the game
+  sprite **it = sprites.allocated_list();
+  const unsigned len = sprites.allocated_list_len();
+  for (unsigned i = 0; i < len; i++) {
+    it[i]->img = nullptr;
+  }
+  render_sprites();
+  memcpy(background, framebuffer, sizeof(background));
+
+  for (unsigned i = 0; i < count; i++) {
+    const unsigned img_ix = unsigned(check_rand(0, sprite_imgs_count));
+    const uint8_t *img = sprite_imgs[img_ix];
+    if (check_rand(0, 1) < 0.5f) {
+      memcpy(img_copy, img, img_size);
+      img = img_copy;
+    }
+    for (uint16_t &c : palette) {
+      c = uint16_t(check_rand(0, 65536));
+    }
+    sprite *spr = sprites.allocate_instance();
+    spr->obj = &obj;
+    spr->img = img;
+    spr->palette = check_rand(0, 1) < 0.5f ? palette : nullptr;
+    spr->flip = uint8_t(check_rand(0, 4));
+    spr->scr_x = int16_t(
+        check_rand(-float(sprite_width), float(display_width + sprite_width)));
+    spr->scr_y = int16_t(check_rand(-float(sprite_height),
+                                    float(display_height + sprite_height)));
+    render_sprites();
+
+    const uint16_t *pal = spr->palette ? spr->palette : palette_sprites;
+    for (unsigned y = 0; y < display_height; y++) {
+      for (unsigned x = 0; x < display_width; x++) {
+        const unsigned px = y * display_width + x;
+        uint16_t expected = background[px];
+        const int col = int(x) - spr->scr_x;
+        const int row = int(y) - spr->scr_y;
+        if (col >= 0 and col < int(sprite_width) and row >= 0 and
+            row < int(sprite_height)) {
+          const unsigned c = spr->flip & sprite_flip_h
+                                 ? sprite_width - 1 - unsigned(col)
+                                 : unsigned(col);
+          const unsigned r = spr->flip & sprite_flip_v
+                                 ? sprite_height - 1 - unsigned(row)
+                                 : unsigned(row);
+          const uint8_t color_ix = img[r * sprite_width + c];
+          if (color_ix) {
+            expected = pal[color_ix];
+          }
+        }
+        if (framebuffer[px] != expected) {
+          fprintf(stderr,
+                  "!!! sprite %u img=%u copy=%d palette=%d flip=%u at %d, %d "
+                  "differs at pixel %u, %u\n",
+                  i, img_ix, img == img_copy, spr->palette != nullptr,
+                  spr->flip, spr->scr_x, spr->scr_y, x, y);
+          return false;
+        }
+      }
+    }
+
+    spr->img = nullptr;
+    spr->palette = nullptr;
+    spr->flip = sprite_flip_none;
+    sprites.free_instance(spr);
+    sprites.apply_free();
+  }
+  return true;
+}
+
+// scenario starting with the game as set up by 'main_setup()' and, if not
+// nullptr, 'wave' started at first frame instead of the scripted waves
+class scenario {
+public:
+  const char *name;
+  wave_func_ptr wave;
+};
+
+static constexpr scenario scenarios[]{
+    {"game", nullptr},     {"wave_1", main_wave_1}, {"wave_2", main_wave_2},
+    {"wave_3", main_wave_3}, {"wave_4", main_wave_4},
+};
+
+// frame time at 30 frames per second
+static constexpr unsigned frame_ms = 33;
+
+// x of the touch screen firing bullets from the center of the screen
+static constexpr int16_t touch_x = touch_screen_min_x + touch_screen_range_x / 2;
+
+auto main(int argc, char **argv) -> int {
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s scenario [frames] [check]\n"
+            "       %s flip [sprites]\n",
+            argv[0], argv[0]);
+    return 1;
+  }
+  if (not strcmp(argv[1], "flip")) {
+    const unsigned count = argc > 2 ? unsigned(atoi(argv[2])) : 1000;
+    srand(0);
+    engine_setup();
+    unsigned long ms = 0;
+    clk.init(ms, 2000);
+    main_setup();
+    if (not check_sprite_transforms(count)) {
+      return 1;
+    }
+    printf("flip     sprites=%u same as reference\n", count);
+    return 0;
+  }
+  const scenario *scn = nullptr;
+  for (const scenario &s : scenarios) {
+    if (not strcmp(argv[1], s.name)) {
+      scn = &s;
+    }
+  }
+  if (not scn) {
+    fprintf(stderr, "unknown scenario '%s'\n", argv[1]);
+    return 1;
+  }
+  const unsigned frames = argc > 2 ? unsigned(atoi(argv[2])) : 1000;
+  const bool check = argc > 3 and not strcmp(argv[3], "check");
+  if (check and not engine_object_grid) {
+    fprintf(stderr, "check requires 'engine_object_grid'\n");
+    return 1;
+  }
+
+  srand(0);
+  engine_setup();
+  unsigned long ms = 0;
+  clk.init(ms, 2000);
+  main_setup();
+  if (scn->wave) {
+    wave_triggers_ix = wave_triggers_len;
+    scn->wave();
+  }
+
+  unsigned objs_max = 0;
+  unsigned queries = 0;
+  const bench_clock::time_point t0 = bench_clock::now();
+  phase_start = t0;
+  for (unsigned i = 0; i < frames; i++) {
+    ms += frame_ms;
+    clk.on_frame(ms);
+    main_on_touch_screen(touch_x, 0, 0);
+    engine_loop();
+    if (objects.allocated_list_len() > objs_max) {
+      objs_max = objects.allocated_list_len();
+    }
+    if (check) {
+      const unsigned n = check_object_grid();
+      if (n == 0) {
+        fprintf(stderr, "!!! object grid differs at frame %u\n", i);
+        return 1;
+      }
+      queries += n;
+    }
+  }
+  const uint64_t total_ns = uint64_t(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now() -
+                                                           t0)
+          .count());
+
+  // fnv-1a hash of the last frame
+  uint32_t hash = 2166136261u;
+  for (const uint16_t px : framebuffer) {
+    hash = (hash ^ px) * 16777619u;
+  }
+
+  printf("%-8s frames=%u objs_max=%u hash=%08x  ns/frame: total=%llu "
+         "update=%llu pre_render=%llu collisions=%llu render=%llu "
+         "game=%llu stream=%llu\n",
+         scn->name, frames, objs_max, hash,
+         (unsigned long long)(total_ns / frames),
+         (unsigned long long)(phase_ns[phase_update] / frames),
+         (unsigned long long)(phase_ns[phase_pre_render] / frames),
+         (unsigned long long)(phase_ns[phase_collisions] / frames),
+         (unsigned long long)(phase_ns[phase_render] / frames),
+         (unsigned long long)(phase_ns[phase_game] / frames),
+         (unsigned long long)(phase_ns[phase_stream] / frames));
+  if (check) {
+    printf("  object grid: %u queries same as scan\n", queries);
+  }
+  if (engine_class_stats) {
+    for (unsigned c = 0; c < object_class_count; c++) {
+      const object_class_stats::entry &e = object_class_stats.of_class[c];
+      if (e.updates == 0 and e.allocs == 0) {
+        continue;
+      }
+      printf("  %-16s updates/frame=%u ns/update=%u allocs=%u frees=%u\n",
+             object_class_names[c], e.updates / frames,
+             e.updates ? e.update_ticks / e.updates : 0, e.allocs, e.frees);
+    }
+  }
+  return 0;
+}
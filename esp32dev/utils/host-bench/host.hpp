@@ -0,0 +1,22 @@
+#pragma once
+// subset of the Arduino platform used by the engine and game on the host
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// serial port printing to stderr
+class host_serial {
+public:
+  auto printf(const char *format, ...) -> int
+      __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    const int n = vfprintf(stderr, format, args);
+    va_end(args);
+    return n;
+  }
+} static Serial{};
@@ -0,0 +1,18 @@
+#!/bin/bash
+# builds, checks rendering of flipped sprites and runs all scenarios
+# usage: run.sh [frames]
+set -e
+cd $(dirname "$0")
+
+# -Os is the optimization used by the device build
+# note. 'o1store' assigns 'alloc_ptr' of an instance before its constructor
+#       runs, a store that is discarded by gcc lifetime dead store elimination
+# note. extra compiler flags in 'CXXFLAGS', e.g. -DUSE_ASSET_PACK
+g++ -std=gnu++11 -Os -fno-lifetime-dse -Wall -Wextra -Wno-unused-parameter \
+    $CXXFLAGS -o bench bench.cpp
+
+./bench flip
+
+for scenario in game wave_1 wave_2 wave_3 wave_4; do
+    ./bench $scenario "$@"
+done
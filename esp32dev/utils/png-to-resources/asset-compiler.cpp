@@ -0,0 +1,357 @@
+// compiles paletted png files of 16 x 16 images to game resources
+//
+// usage: asset-compiler command png [arguments]
+//   palette png   palette as rgb 565 with lower and higher byte swapped
+//   images png [dedup [map_in map_out]]
+//                 pixels of the 16 x 16 images, one image per line, with
+//                 'dedup' identical images are emitted once and, if given,
+//                 the tile map 'map_in' is written to 'map_out' with the new
+//                 indexes
+//   spans png [rows] [dedup]
+//                 opaque spans of the rows of the images, one image per line,
+//                 or with 'rows' the index of the first span of every row and
+//                 the total number of spans, with 'dedup' of the images
+//                 emitted by 'images png dedup'
+//   usage png     palette entries used by the png and colors of every image
+//
+// the images are read left to right, top to bottom
+// statistics are printed to stderr
+// note. with 'dedup' images keep their index if no duplicate precedes them,
+//       a warning is printed for images that move since game code refers to
+//       sprite images by index
+// note. palette index 0 is transparent in sprites
+
+#include <png.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+
+static constexpr unsigned img_width = 16;
+static constexpr unsigned img_height = 16;
+static constexpr unsigned img_size = img_width * img_height;
+
+using img = std::vector<uint8_t>;
+
+// paletted png read with libpng
+class png_paletted {
+public:
+  unsigned width = 0;
+  unsigned height = 0;
+  // palette index of every pixel
+  std::vector<uint8_t> pixels;
+  std::vector<png_color> palette;
+
+  auto load(const char *filename) -> bool {
+    FILE *f = fopen(filename, "rb");
+    if (!f) {
+      fprintf(stderr, "error: cannot open '%s'\n", filename);
+      return false;
+    }
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr,
+                                             nullptr, nullptr);
+    png_infop info = png_create_info_struct(png);
+    // note. libpng reports errors with 'longjmp' to here thus no object with
+    //       a destructor may be created below, rows are read into 'pixels'
+    if (setjmp(png_jmpbuf(png))) {
+      fprintf(stderr, "error: cannot read '%s'\n", filename);
+      png_destroy_read_struct(&png, &info, nullptr);
+      fclose(f);
+      return false;
+    }
+    png_init_io(png, f);
+    png_read_info(png, info);
+    if (png_get_color_type(png, info) != PNG_COLOR_TYPE_PALETTE) {
+      fprintf(stderr, "error: '%s' is not paletted\n", filename);
+      png_destroy_read_struct(&png, &info, nullptr);
+      fclose(f);
+      return false;
+    }
+    // one byte per pixel for bit depths less than 8
+    png_set_packing(png);
+    const int passes = png_set_interlace_handling(png);
+    png_read_update_info(png, info);
+
+    width = png_get_image_width(png, info);
+    height = png_get_image_height(png, info);
+    png_colorp colors = nullptr;
+    int colors_len = 0;
+    png_get_PLTE(png, info, &colors, &colors_len);
+    palette.assign(colors, colors + colors_len);
+
+    pixels.resize(width * height);
+    for (int pass = 0; pass < passes; pass++) {
+      for (unsigned y = 0; y < height; y++) {
+        png_read_row(png, &pixels[y * width], nullptr);
+      }
+    }
+    png_read_end(png, nullptr);
+    png_destroy_read_struct(&png, &info, nullptr);
+    fclose(f);
+    return true;
+  }
+
+  // returns the 16 x 16 images left to right, top to bottom
+  auto images() const -> std::vector<img> {
+    std::vector<img> imgs;
+    for (unsigned row = 0; row + img_height <= height; row += img_height) {
+      for (unsigned col = 0; col + img_width <= width; col += img_width) {
+        img im(img_size);
+        for (unsigned y = 0; y < img_height; y++) {
+          memcpy(&im[y * img_width], &pixels[(row + y) * width + col],
+                 img_width);
+        }
+        imgs.push_back(im);
+      }
+    }
+    return imgs;
+  }
+};
+
+static void print_palette(const png_paletted &png) {
+  for (const png_color &c : png.palette) {
+    const unsigned rgb565 =
+        unsigned(c.red & 0xf8) << 8 | unsigned(c.green & 0xfc) << 3 |
+        unsigned(c.blue >> 3);
+    printf("0x%02X%02X,\n", rgb565 & 0xff, rgb565 >> 8);
+  }
+  fprintf(stderr, "%zu palette entries\n", png.palette.size());
+}
+
+static void print_img(const img &im) {
+  printf("{");
+  for (unsigned i = 0; i < img_size; i++) {
+    printf(i ? ",%u" : "%u", im[i]);
+  }
+  printf("},\n");
+}
+
+// writes 'map_in' to 'map_out' with the cells in rows starting with '{'
+// replaced by 'remap'
+static auto remap_tile_map(const char *map_in, const char *map_out,
+                           const std::vector<unsigned> &remap) -> bool {
+  FILE *in = fopen(map_in, "r");
+  if (!in) {
+    fprintf(stderr, "error: cannot open '%s'\n", map_in);
+    return false;
+  }
+  FILE *out = fopen(map_out, "w");
+  if (!out) {
+    fprintf(stderr, "error: cannot create '%s'\n", map_out);
+    fclose(in);
+    return false;
+  }
+  bool ok = true;
+  char line[4096];
+  while (fgets(line, sizeof(line), in)) {
+    const char *p = line;
+    while (*p == ' ' or *p == '\t') {
+      p++;
+    }
+    if (*p != '{') {
+      fputs(line, out);
+      continue;
+    }
+    fputs("{", out);
+    p++;
+    bool first = true;
+    while (*p and *p != '}') {
+      char *end = nullptr;
+      const unsigned long ix = strtoul(p, &end, 0);
+      if (end == p) {
+        p++;
+        continue;
+      }
+      if (ix >= remap.size()) {
+        fprintf(stderr, "error: tile %lu in map is not in png\n", ix);
+        ok = false;
+      }
+      fprintf(out, first ? "%u" : ",%u", ix < remap.size() ? remap[ix] : 0);
+      first = false;
+      p = end;
+    }
+    fputs("},\n", out);
+  }
+  fclose(in);
+  fclose(out);
+  return ok;
+}
+
+// returns the images in 'imgs' without duplicates and in 'remap' the index in
+// the returned images of every image in 'imgs'
+static auto unique_images(const std::vector<img> &imgs,
+                          std::vector<unsigned> &remap) -> std::vector<img> {
+  // index in output of the first occurrence of every image
+  std::map<img, unsigned> unique;
+  std::vector<img> out;
+  remap.resize(imgs.size());
+  for (unsigned i = 0; i < imgs.size(); i++) {
+    const auto it = unique.find(imgs[i]);
+    if (it != unique.end()) {
+      remap[i] = it->second;
+      continue;
+    }
+    remap[i] = unsigned(out.size());
+    unique[imgs[i]] = remap[i];
+    out.push_back(imgs[i]);
+  }
+  return out;
+}
+
+// returns the images of 'png', without duplicates if 'dedup'
+static auto images_of(const png_paletted &png, const bool dedup)
+    -> std::vector<img> {
+  if (not dedup) {
+    return png.images();
+  }
+  std::vector<unsigned> remap;
+  return unique_images(png.images(), remap);
+}
+
+static auto print_images(const png_paletted &png, const bool dedup,
+                         const char *map_in, const char *map_out) -> bool {
+  const std::vector<img> imgs = png.images();
+  if (not dedup) {
+    for (const img &im : imgs) {
+      print_img(im);
+    }
+    fprintf(stderr, "%zu images\n", imgs.size());
+    return true;
+  }
+  std::vector<unsigned> remap;
+  const std::vector<img> unique = unique_images(imgs, remap);
+  for (const img &im : unique) {
+    print_img(im);
+  }
+  // true if first occurrence of output image has been seen
+  std::vector<bool> seen(unique.size());
+  for (unsigned i = 0; i < imgs.size(); i++) {
+    if (seen[remap[i]]) {
+      fprintf(stderr, "image %u -> %u\n", i, remap[i]);
+      continue;
+    }
+    seen[remap[i]] = true;
+    if (i != remap[i]) {
+      fprintf(stderr, "warning: image %u moved to %u\n", i, remap[i]);
+    }
+  }
+  fprintf(stderr, "%zu images, %zu unique\n", imgs.size(), unique.size());
+  if (not map_in) {
+    return true;
+  }
+  return remap_tile_map(map_in, map_out, remap);
+}
+
+static void print_spans(const png_paletted &png, const bool rows,
+                        const bool dedup) {
+  unsigned span_ix = 0;
+  for (const img &im : images_of(png, dedup)) {
+    for (unsigned y = 0; y < img_height; y++) {
+      if (rows) {
+        printf("%u,", span_ix);
+      }
+      const uint8_t *px = &im[y * img_width];
+      unsigned x = 0;
+      while (x < img_width) {
+        if (px[x] == 0) {
+          x++;
+          continue;
+        }
+        const unsigned start = x;
+        while (x < img_width and px[x] != 0) {
+          x++;
+        }
+        if (not rows) {
+          printf("{%u,%u},", start, x - start);
+        }
+        span_ix++;
+      }
+    }
+    printf("\n");
+  }
+  if (rows) {
+    printf("%u\n", span_ix);
+  }
+  fprintf(stderr, "%u spans\n", span_ix);
+}
+
+static void print_usage(const png_paletted &png) {
+  unsigned counts[256]{};
+  for (const uint8_t px : png.pixels) {
+    counts[px]++;
+  }
+  unsigned used = 0;
+  for (unsigned i = 0; i < 256; i++) {
+    if (counts[i]) {
+      printf("palette %3u: %u px\n", i, counts[i]);
+      used++;
+    }
+  }
+  printf("palette entries: %zu, used: %u\n", png.palette.size(), used);
+
+  const std::vector<img> imgs = png.images();
+  unsigned empty = 0;
+  for (unsigned i = 0; i < imgs.size(); i++) {
+    bool seen[256]{};
+    unsigned colors = 0;
+    bool opaque = false;
+    for (const uint8_t px : imgs[i]) {
+      if (not seen[px]) {
+        seen[px] = true;
+        colors++;
+      }
+      opaque = opaque or px != 0;
+    }
+    if (not opaque) {
+      empty++;
+      continue;
+    }
+    printf("image %3u: %u colors\n", i, colors);
+  }
+  printf("images: %zu, empty: %u\n", imgs.size(), empty);
+}
+
+auto main(int argc, char **argv) -> int {
+  if (argc < 3) {
+    fprintf(stderr, "usage: asset-compiler palette|images|spans|usage png "
+                    "[arguments]\n");
+    return 1;
+  }
+  const char *cmd = argv[1];
+  png_paletted png;
+  if (not png.load(argv[2])) {
+    return 1;
+  }
+  if (not strcmp(cmd, "palette")) {
+    print_palette(png);
+  } else if (not strcmp(cmd, "images")) {
+    const bool dedup = argc > 3 and not strcmp(argv[3], "dedup");
+    if (dedup and argc != 4 and argc < 6) {
+      fprintf(stderr, "usage: asset-compiler images png dedup [map_in "
+                      "map_out]\n");
+      return 1;
+    }
+    const bool map = dedup and argc >= 6;
+    if (not print_images(png, dedup, map ? argv[4] : nullptr,
+                         map ? argv[5] : nullptr)) {
+      return 1;
+    }
+  } else if (not strcmp(cmd, "spans")) {
+    bool rows = false;
+    bool dedup = false;
+    for (int i = 3; i < argc; i++) {
+      rows = rows or not strcmp(argv[i], "rows");
+      dedup = dedup or not strcmp(argv[i], "dedup");
+    }
+    print_spans(png, rows, dedup);
+  } else if (not strcmp(cmd, "usage")) {
+    print_usage(png);
+  } else {
+    fprintf(stderr, "error: unknown command '%s'\n", cmd);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,63 @@
+import os
+import re
+import struct
+
+# format of the binary asset pack read by 'asset_pack' in 'engine.hpp'
+# little endian, blocks aligned to 4 B:
+#   header: "APAK", u16 version, u16 blocks count, u32 size of pack, u32 fnv-1a
+#           hash of the bytes after the header
+#   index: for every block 4 characters id, u32 offset from start of pack,
+#          u32 size
+#   blocks
+
+magic = b"APAK"
+version = 1
+header_format = "<4sHHII"
+header_size = struct.calcsize(header_format)
+entry_format = "<4sII"
+entry_size = struct.calcsize(entry_format)
+align = 4
+
+game_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..",
+                        "game")
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+def read_defs(filename=os.path.join(game_dir, "defs.hpp")):
+    # constants and the size of 'tile_ix' used by the engine, ignoring
+    # commented out configurations
+    defs = {}
+    with open(filename) as f:
+        for line in f:
+            m = re.match(r"\s*static constexpr unsigned (\w+) = (\d+);", line)
+            if m:
+                defs[m.group(1)] = int(m.group(2))
+            m = re.match(r"\s*using tile_ix = uint(8|16)_t;", line)
+            if m:
+                defs["tile_ix_size"] = int(m.group(1)) // 8
+    return defs
+
+def tile_map_run_size(defs):
+    # 'class tile_map_run' is an uint8_t count followed by a 'tile_ix'
+    return 2 * defs["tile_ix_size"]
+
+def expected_sizes(defs):
+    # size of every block or None if it depends on the content
+    sprite_size = 16 * 16
+    tile_size = 16 * 16
+    return {
+        b"PALT": 256 * 2,
+        b"PALS": 256 * 2,
+        b"TILE": defs["tile_count"] * tile_size,
+        b"SPRT": defs["sprite_imgs_count"] * sprite_size,
+        b"SPAN": None,
+        b"SPRW": (defs["sprite_imgs_count"] * 16 + 1) * 2,
+        b"TMAP": defs["tile_map_height"] * defs["tile_map_width"] *
+        defs["tile_ix_size"],
+        b"TRUN": None,
+        b"TRRW": defs["tile_map_height"] * 2,
+    }
@@ -0,0 +1,62 @@
+#!/bin/python3
+import sys
+
+# prints the rows of the tile map in 'resources/tile_map.hpp' compressed as
+# runs of count and tile or, with argument 'rows', the index of the first run
+# of every row
+# note. identical rows share the same runs
+# note. statistics are printed to stderr
+
+def read_tile_map(filename):
+    rows = []
+    with open(filename) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("{"):
+                continue
+            cells = line.strip("{},").split(",")
+            rows.append([int(c) for c in cells])
+    return rows
+
+def row_runs(row):
+    runs = []
+    x = 0
+    while x < len(row):
+        start = x
+        while x < len(row) and row[x] == row[start]:
+            x += 1
+        runs.append((x - start, row[start]))
+    return runs
+
+def print_tile_map_compressed(filename, print_rows):
+    rows = read_tile_map(filename)
+    # index of first run of distinct rows
+    dictionary = {}
+    row_ix = []
+    runs = []
+    for row in rows:
+        key = tuple(row)
+        if key not in dictionary:
+            dictionary[key] = len(runs)
+            runs.extend(row_runs(row))
+        row_ix.append(dictionary[key])
+
+    print("// clang-format off")
+    if print_rows:
+        for i in range(0, len(row_ix), 16):
+            print(",".join(str(ix) for ix in row_ix[i:i + 16]) + ",")
+    else:
+        for count, tile in runs:
+            print(f"{{{count},{tile}}},", end="")
+        print()
+
+    cells = sum(len(row) for row in rows)
+    print(f"tile map {len(rows)} rows, {len(dictionary)} distinct, "
+          f"{cells} cells, {len(runs)} runs", file=sys.stderr)
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: compress-tile-map <tile_map.hpp> [rows]")
+        sys.exit(1)
+    print_tile_map_compressed(
+        sys.argv[1], len(sys.argv) > 2 and sys.argv[2] == "rows")
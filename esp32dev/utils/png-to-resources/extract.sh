@@ -2,8 +2,20 @@
 set -e
 cd $(dirname "$0")
 
-./read-palette.py sprites.png > ../../game/resources/palette_sprites.hpp
-./read-sprites.py sprites.png > ../../game/resources/sprite_imgs.hpp
+# build the asset compiler when its source is newer
+if [ ! -x asset-compiler ] || [ asset-compiler.cpp -nt asset-compiler ]; then
+    g++ -std=gnu++11 -O2 -Wall -Wextra -o asset-compiler asset-compiler.cpp -lpng
+fi
 
-./read-palette.py tiles.png > ../../game/resources/palette_tiles.hpp
-./read-sprites.py tiles.png > ../../game/resources/tile_imgs.hpp
\ No newline at end of file
+./asset-compiler palette sprites.png > ../../game/resources/palette_sprites.hpp
+# identical sprite images are emitted once, a warning is printed for images
+# that move since game code refers to sprite images by index
+./asset-compiler images sprites.png dedup > ../../game/resources/sprite_imgs.hpp
+./asset-compiler spans sprites.png dedup > ../../game/resources/sprite_imgs_spans.hpp
+./asset-compiler spans sprites.png rows dedup > ../../game/resources/sprite_imgs_spans_rows.hpp
+
+./asset-compiler palette tiles.png > ../../game/resources/palette_tiles.hpp
+./asset-compiler images tiles.png > ../../game/resources/tile_imgs.hpp
+
+./compress-tile-map.py ../../game/resources/tile_map.hpp > ../../game/resources/tile_map_runs.hpp
+./compress-tile-map.py ../../game/resources/tile_map.hpp rows > ../../game/resources/tile_map_runs_rows.hpp
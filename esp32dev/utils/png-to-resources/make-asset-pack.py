@@ -0,0 +1,95 @@
+#!/bin/python3
+import os
+import re
+import struct
+import sys
+
+import asset_pack
+
+# writes the resources in 'game/resources/*.hpp' to a binary asset pack that is
+# memory mapped by the engine when 'USE_ASSET_PACK' is defined
+# note. the sizes of the blocks are taken from 'game/defs.hpp'
+
+def read_values(filename):
+    # integers in a resource file ignoring comments
+    values = []
+    with open(filename) as f:
+        for line in f:
+            line = line.split("//")[0]
+            values.extend(int(v, 0)
+                          for v in re.findall(r"0x[0-9A-Fa-f]+|\d+", line))
+    return values
+
+def pack_values(values, fmt, count):
+    # the values padded with zeros to 'count' as zero initialized C arrays
+    if len(values) > count:
+        raise ValueError("%d values, expected at most %d" %
+                         (len(values), count))
+    values = values + [0] * (count - len(values))
+    return struct.pack("<%d%s" % (count, fmt), *values)
+
+def tile_map_runs(values, tile_ix_size):
+    data = bytearray()
+    for i in range(0, len(values), 2):
+        count, tile = values[i], values[i + 1]
+        if tile_ix_size == 1:
+            data += struct.pack("<BB", count, tile)
+        else:
+            data += struct.pack("<BxH", count, tile)
+    return bytes(data)
+
+def make_asset_pack(filename):
+    defs = asset_pack.read_defs()
+    res = os.path.join(asset_pack.game_dir, "resources")
+    tile_ix_fmt = "B" if defs["tile_ix_size"] == 1 else "H"
+    sprite_rows = defs["sprite_imgs_count"] * 16
+    cells = defs["tile_map_height"] * defs["tile_map_width"]
+
+    def values(name):
+        return read_values(os.path.join(res, name))
+
+    spans = values("sprite_imgs_spans.hpp")
+    blocks = [
+        (b"PALT", pack_values(values("palette_tiles.hpp"), "H", 256)),
+        (b"PALS", pack_values(values("palette_sprites.hpp"), "H", 256)),
+        (b"TILE", pack_values(values("tile_imgs.hpp"), "B",
+                              defs["tile_count"] * 256)),
+        (b"SPRT", pack_values(values("sprite_imgs.hpp"), "B",
+                              defs["sprite_imgs_count"] * 256)),
+        (b"SPAN", pack_values(spans, "B", len(spans))),
+        (b"SPRW", pack_values(values("sprite_imgs_spans_rows.hpp"), "H",
+                              sprite_rows + 1)),
+        (b"TMAP", pack_values(values("tile_map.hpp"), tile_ix_fmt, cells)),
+        (b"TRUN", tile_map_runs(values("tile_map_runs.hpp"),
+                                defs["tile_ix_size"])),
+        (b"TRRW", pack_values(values("tile_map_runs_rows.hpp"), "H",
+                              defs["tile_map_height"])),
+    ]
+
+    offset = asset_pack.header_size + asset_pack.entry_size * len(blocks)
+    index = b""
+    body = b""
+    for block_id, data in blocks:
+        padding = -offset % asset_pack.align
+        body += b"\0" * padding
+        offset += padding
+        index += struct.pack(asset_pack.entry_format, block_id, offset,
+                             len(data))
+        body += data
+        offset += len(data)
+
+    after_header = index + body
+    header = struct.pack(asset_pack.header_format, asset_pack.magic,
+                         asset_pack.version, len(blocks),
+                         asset_pack.header_size + len(after_header),
+                         asset_pack.fnv1a(after_header))
+    with open(filename, "wb") as f:
+        f.write(header + after_header)
+    print("%s: %d B, %d blocks" % (filename, len(header + after_header),
+                                   len(blocks)))
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: make-asset-pack <filename>")
+        sys.exit(1)
+    make_asset_pack(sys.argv[1])
@@ -0,0 +1,108 @@
+#!/bin/python3
+import struct
+import sys
+
+import asset_pack
+
+# checks that an asset pack is well formed and matches 'game/defs.hpp'
+# prints the blocks and the errors found, exit code is 1 if there are errors
+
+def validate(data):
+    errors = []
+    if len(data) < asset_pack.header_size:
+        return ["file smaller than header"]
+    magic, version, blocks_count, size, hash = struct.unpack_from(
+        asset_pack.header_format, data, 0)
+    if magic != asset_pack.magic:
+        return ["unknown magic %r" % magic]
+    if version != asset_pack.version:
+        return ["version %d, expected %d" % (version, asset_pack.version)]
+    if size != len(data):
+        return ["size in header %d, file is %d B" % (size, len(data))]
+    if asset_pack.fnv1a(data[asset_pack.header_size:]) != hash:
+        errors.append("hash mismatch")
+
+    index_end = asset_pack.header_size + asset_pack.entry_size * blocks_count
+    if index_end > size:
+        return errors + ["index out of bounds"]
+
+    defs = asset_pack.read_defs()
+    expected = asset_pack.expected_sizes(defs)
+    blocks = {}
+    for i in range(blocks_count):
+        block_id, offset, block_size = struct.unpack_from(
+            asset_pack.entry_format, data,
+            asset_pack.header_size + i * asset_pack.entry_size)
+        print("  %s  offset=%-8d size=%d" % (block_id.decode(errors="replace"),
+                                            offset, block_size))
+        name = block_id.decode(errors="replace")
+        if block_id in blocks:
+            errors.append("%s: duplicate block" % name)
+        if offset % asset_pack.align:
+            errors.append("%s: offset not aligned to %d B" %
+                          (name, asset_pack.align))
+        if offset < index_end or offset + block_size > size:
+            errors.append("%s: out of bounds" % name)
+            continue
+        if block_id not in expected:
+            errors.append("%s: unknown block" % name)
+        elif expected[block_id] is not None and \
+                expected[block_id] != block_size:
+            errors.append("%s: size %d, expected %d by defs.hpp" %
+                          (name, block_size, expected[block_id]))
+        blocks[block_id] = data[offset:offset + block_size]
+
+    for block_id in expected:
+        if block_id not in blocks:
+            errors.append("%s: missing block" % block_id.decode())
+    if errors:
+        return errors
+
+    # spans of sprite rows are within the spans
+    spans_len = len(blocks[b"SPAN"]) // 2
+    spans_rows = struct.unpack("<%dH" % (len(blocks[b"SPRW"]) // 2),
+                               blocks[b"SPRW"])
+    if any(a > b for a, b in zip(spans_rows, spans_rows[1:])):
+        errors.append("SPRW: not ascending")
+    if spans_rows[-1] > spans_len:
+        errors.append("SPRW: ends at span %d, there are %d spans" %
+                      (spans_rows[-1], spans_len))
+
+    # tiles in map are within the tile images
+    fmt = "B" if defs["tile_ix_size"] == 1 else "H"
+    cells = struct.unpack("<%d%s" % (len(blocks[b"TMAP"]) // struct.calcsize(fmt),
+                                     fmt), blocks[b"TMAP"])
+    if max(cells) >= defs["tile_count"]:
+        errors.append("TMAP: tile %d, there are %d tiles" %
+                      (max(cells), defs["tile_count"]))
+
+    # every row of runs decodes to a row of the tile map
+    run_size = asset_pack.tile_map_run_size(defs)
+    runs = blocks[b"TRUN"]
+    runs_len = len(runs) // run_size
+    runs_rows = struct.unpack("<%dH" % defs["tile_map_height"],
+                              blocks[b"TRRW"])
+    width = defs["tile_map_width"]
+    for y, ix in enumerate(runs_rows):
+        row = []
+        while len(row) < width and ix < runs_len:
+            count = runs[ix * run_size]
+            tile = struct.unpack_from("<" + fmt, runs,
+                                      ix * run_size + run_size // 2)[0]
+            row += [tile] * count
+            ix += 1
+        if row != list(cells[y * width:(y + 1) * width]):
+            errors.append("TRUN: row %d does not decode to TMAP row" % y)
+            break
+    return errors
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: validate-asset-pack <filename>")
+        sys.exit(1)
+    with open(sys.argv[1], "rb") as f:
+        errors = validate(f.read())
+    for error in errors:
+        print("error: " + error)
+    print("ok" if not errors else "%d errors" % len(errors))
+    sys.exit(1 if errors else 0)
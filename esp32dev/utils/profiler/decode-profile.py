@@ -0,0 +1,106 @@
+#!/bin/python3
+import struct
+import sys
+
+# decodes the binary dumps of 'profiler.hpp' found in a capture of the serial
+# output and prints statistics of the phases and a flame chart of the frames
+# usage: decode-profile.py capture.bin [chart width]
+
+# frame budget at 30 frames per second
+budget_us = 33333
+
+def read_cstr(data, pos):
+    end = data.index(b"\0", pos)
+    return data[pos:end].decode(), end + 1
+
+def decode(data, pos):
+    ticks_per_us, phases_count, workers_count, frames_count = struct.unpack_from(
+        "<IBBH", data, pos)
+    pos += 8
+    names = []
+    for _ in range(phases_count):
+        name, pos = read_cstr(data, pos)
+        names.append(name)
+    frames = []
+    for _ in range(frames_count):
+        phases = struct.unpack_from("<%dI" % phases_count, data, pos)
+        pos += 4 * phases_count
+        raster = struct.unpack_from("<%dI" % workers_count, data, pos)
+        pos += 4 * workers_count
+        dma_wait, = struct.unpack_from("<I", data, pos)
+        pos += 4
+        bands = struct.unpack_from("<%dH" % workers_count, data, pos)
+        pos += 2 * workers_count
+        frames.append({
+            "phases": [t / ticks_per_us for t in phases],
+            "raster": [t / ticks_per_us for t in raster],
+            "dma_wait": dma_wait / ticks_per_us,
+            "bands": bands,
+        })
+    return names, workers_count, frames
+
+def stats(values):
+    values = sorted(values)
+    return (values[0], sum(values) / len(values), values[len(values) * 99 // 100],
+            values[-1])
+
+def print_stats(names, workers_count, frames):
+    totals = [sum(f["phases"]) for f in frames]
+    print("%-12s %9s %9s %9s %9s %6s" % ("us", "min", "avg", "p99", "max",
+                                          "avg%"))
+    rows = [(name, [f["phases"][i] for f in frames])
+            for i, name in enumerate(names)]
+    rows.append(("frame", totals))
+    rows += [("raster %d" % w, [f["raster"][w] for f in frames])
+             for w in range(workers_count)]
+    rows.append(("dma wait", [f["dma_wait"] for f in frames]))
+    avg_total = sum(totals) / len(totals)
+    for name, values in rows:
+        mn, avg, p99, mx = stats(values)
+        print("%-12s %9.0f %9.0f %9.0f %9.0f %5.1f%%" %
+              (name, mn, avg, p99, mx, 100 * avg / avg_total))
+    over = sum(1 for t in totals if t > budget_us)
+    print("frames over %d us budget: %d of %d" % (budget_us, over, len(frames)))
+
+def print_flame_chart(names, frames, width):
+    # each phase is drawn with the first letter of its name, in upper case if
+    # the letter is already used by a previous phase
+    letters = []
+    for name in names:
+        letter = name[0]
+        if letter in letters:
+            letter = letter.upper()
+        letters.append(letter)
+    print("legend: " + "  ".join("%s=%s" % (letter, name)
+                                 for letter, name in zip(letters, names)) +
+          "  |=%d us budget" % budget_us)
+    scale = max(max(sum(f["phases"]) for f in frames), budget_us) / width
+    budget_col = int(budget_us / scale)
+    for i, f in enumerate(frames):
+        bar = ""
+        for letter, us in zip(letters, f["phases"]):
+            bar += letter * int(round(us / scale))
+        bar = bar.ljust(budget_col)
+        bar = bar[:budget_col] + "|" + bar[budget_col:]
+        print("%4d %7.0f %s" % (i, sum(f["phases"]), bar))
+
+def main():
+    if len(sys.argv) < 2:
+        print("usage: decode-profile.py capture.bin [chart width]")
+        sys.exit(1)
+    width = int(sys.argv[2]) if len(sys.argv) > 2 else 100
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+    pos = data.find(b"PRF2")
+    if pos < 0:
+        print("no profile dump found")
+        sys.exit(1)
+    while pos >= 0:
+        names, workers_count, frames = decode(data, pos + 4)
+        if frames:
+            print_stats(names, workers_count, frames)
+            print()
+            print_flame_chart(names, frames, width)
+        pos = data.find(b"PRF2", pos + 4)
+
+main()
@@ -0,0 +1,189 @@
+// host micro-benchmark of the tile row kernels in 'render_kernels.hpp'
+// compared with the per-byte loops they replaced in 'render_scanline'
+//
+// renders 'frames' frames of 240 x 320 tile pixels from a random tile map at
+// every x offset, checks that the results are identical and prints the time
+// per frame
+// note. 'palette_expand_reverse' used for mirrored sprites is only checked
+
+#include "../../render_kernels.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+static constexpr unsigned tile_width = 16;
+static constexpr unsigned tile_height = 16;
+static constexpr unsigned display_width = 240;
+static constexpr unsigned display_height = 320;
+static constexpr unsigned tile_map_width = 15;
+static constexpr unsigned tile_map_height = 32;
+static constexpr unsigned tile_count = 256;
+
+class tile {
+public:
+  alignas(4) uint8_t data[tile_width * tile_height];
+} static tiles[tile_count];
+
+static uint8_t tile_map[tile_map_height][tile_map_width + 1];
+static uint16_t palette[256];
+// note. one extra pixel for rendering at odd offset
+alignas(4) static uint16_t scanline_ref[display_width + 1];
+alignas(4) static uint16_t scanline_krn[display_width + 1];
+
+// the per-byte loops replaced by the kernels
+static void render_tiles_reference(uint16_t *render_buf_ptr,
+                                   const unsigned tile_dx,
+                                   const uint8_t *tiles_map_row_ptr,
+                                   const unsigned tile_sub_y_times_tile_width) {
+  {
+    const uint8_t *tile_data_ptr =
+        tiles[*tiles_map_row_ptr].data + tile_sub_y_times_tile_width + tile_dx;
+    for (unsigned i = tile_dx; i < tile_width; i++) {
+      *render_buf_ptr++ = palette[*tile_data_ptr++];
+    }
+  }
+  const unsigned tx_max = display_width / tile_width;
+  for (unsigned tx = 1; tx < tx_max; tx++) {
+    const uint8_t *tile_data_ptr =
+        tiles[tiles_map_row_ptr[tx]].data + tile_sub_y_times_tile_width;
+    for (unsigned i = 0; i < tile_width; i++) {
+      *render_buf_ptr++ = palette[*tile_data_ptr++];
+    }
+  }
+  if (tile_dx) {
+    const uint8_t *tile_data_ptr =
+        tiles[tiles_map_row_ptr[tx_max]].data + tile_sub_y_times_tile_width;
+    for (unsigned i = 0; i < tile_dx; i++) {
+      *render_buf_ptr++ = palette[*tile_data_ptr++];
+    }
+  }
+}
+
+// same as 'render_scanline' using the kernels
+static void render_tiles_kernels(uint16_t *render_buf_ptr,
+                                 const unsigned tile_dx,
+                                 const uint8_t *tiles_map_row_ptr,
+                                 const unsigned tile_sub_y_times_tile_width) {
+  const unsigned tile_width_minus_dx = tile_width - tile_dx;
+  palette_expand(render_buf_ptr,
+                 tiles[*tiles_map_row_ptr].data + tile_sub_y_times_tile_width +
+                     tile_dx,
+                 palette, tile_width_minus_dx);
+  render_buf_ptr += tile_width_minus_dx;
+  const unsigned tx_max = display_width / tile_width;
+  for (unsigned tx = 1; tx < tx_max; tx++) {
+    palette_expand_16(render_buf_ptr,
+                      tiles[tiles_map_row_ptr[tx]].data +
+                          tile_sub_y_times_tile_width,
+                      palette);
+    render_buf_ptr += tile_width;
+  }
+  if (tile_dx) {
+    palette_expand(render_buf_ptr,
+                   tiles[tiles_map_row_ptr[tx_max]].data +
+                       tile_sub_y_times_tile_width,
+                   palette, tile_dx);
+  }
+}
+
+using render_func = void (*)(uint16_t *, unsigned, const uint8_t *, unsigned);
+
+// renders a frame at tile map x offset 'tile_dx' and returns a checksum
+static auto render_frame(render_func fn, uint16_t *scanline,
+                         const unsigned tile_dx) -> uint32_t {
+  uint32_t sum = 0;
+  for (unsigned y = 0; y < display_height; y++) {
+    const unsigned tile_sub_y = y % tile_height;
+    fn(scanline, tile_dx, tile_map[y / tile_height],
+       tile_sub_y * tile_width);
+    sum = sum * 31 + scanline[y % display_width];
+  }
+  return sum;
+}
+
+static auto time_frames(render_func fn, uint16_t *scanline,
+                        const unsigned frames) -> double {
+  uint32_t sum = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (unsigned f = 0; f < frames; f++) {
+    sum += render_frame(fn, scanline, f % tile_width);
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  // keep the result alive
+  if (sum == 1) {
+    printf(" ");
+  }
+  return std::chrono::duration<double, std::micro>(t1 - t0).count() / frames;
+}
+
+int main(int argc, char **argv) {
+  const unsigned frames = argc > 1 ? unsigned(atoi(argv[1])) : 2000;
+
+  srand(1);
+  for (auto &t : tiles) {
+    for (auto &p : t.data) {
+      p = uint8_t(rand());
+    }
+  }
+  for (auto &row : tile_map) {
+    for (auto &c : row) {
+      c = uint8_t(rand());
+    }
+  }
+  for (auto &c : palette) {
+    c = uint16_t(rand());
+  }
+
+  // verify kernels produce same pixels as reference at every x offset
+  for (unsigned dx = 0; dx < tile_width; dx++) {
+    for (unsigned y = 0; y < display_height; y++) {
+      // odd offset exercises the unaligned destination path
+      for (unsigned odd = 0; odd < 2; odd++) {
+        memset(scanline_ref, 0, sizeof(scanline_ref));
+        memset(scanline_krn, 0, sizeof(scanline_krn));
+        const uint8_t *row = tile_map[y / tile_height];
+        const unsigned sub = (y % tile_height) * tile_width;
+        render_tiles_reference(scanline_ref + odd, dx, row, sub);
+        render_tiles_kernels(scanline_krn + odd, dx, row, sub);
+        if (memcmp(scanline_ref, scanline_krn, sizeof(scanline_ref))) {
+          printf("!!! kernel output differs at dx=%u y=%u odd=%u\n", dx, y,
+                 odd);
+          return 1;
+        }
+      }
+    }
+  }
+
+  // verify reverse kernel against per-byte loop for every sprite row length
+  // and start within a tile row
+  for (unsigned x = 0; x < tile_width; x++) {
+    for (unsigned n = 0; n <= x + 1; n++) {
+      memset(scanline_ref, 0, sizeof(scanline_ref));
+      memset(scanline_krn, 0, sizeof(scanline_krn));
+      const uint8_t *src = tiles[x].data + x;
+      for (unsigned i = 0; i < n; i++) {
+        scanline_ref[i] = palette[src[-int(i)]];
+      }
+      palette_expand_reverse(scanline_krn, src, palette, n);
+      if (memcmp(scanline_ref, scanline_krn, sizeof(scanline_ref))) {
+        printf("!!! reverse kernel output differs at x=%u n=%u\n", x, n);
+        return 1;
+      }
+    }
+  }
+
+  // warm up
+  time_frames(render_tiles_reference, scanline_ref, frames / 10 + 1);
+  time_frames(render_tiles_kernels, scanline_krn, frames / 10 + 1);
+
+  const double ref_us =
+      time_frames(render_tiles_reference, scanline_ref, frames);
+  const double krn_us = time_frames(render_tiles_kernels, scanline_krn, frames);
+
+  printf("frames: %u\n", frames);
+  printf("per-byte loops: %8.2f us / frame\n", ref_us);
+  printf("       kernels: %8.2f us / frame\n", krn_us);
+  printf("       speedup: %8.2f x\n", ref_us / krn_us);
+  return 0;
+}
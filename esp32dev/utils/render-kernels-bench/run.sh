@@ -0,0 +1,8 @@
+#!/bin/bash
+set -e
+cd $(dirname "$0")
+
+# -Os is the optimization used by the device build
+# note. extra compiler flags in 'CXXFLAGS', e.g. -O2 after -Os overrides it
+g++ -std=gnu++11 -Os -Wall -Wextra -pedantic $CXXFLAGS -o bench bench.cpp
+./bench "$@"